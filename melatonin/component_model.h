@@ -2,6 +2,7 @@
 
 #include <utility>
 #include "helpers/component_helpers.h"
+#include "helpers/automatic_timings.h"
 #include "juce_gui_basics/juce_gui_basics.h"
 
 namespace melatonin
@@ -9,11 +10,24 @@ namespace melatonin
     class ComponentModel : private juce::Value::Listener, private juce::ComponentListener
     {
     public:
+        // which fields changed, so listeners can skip work that doesn't concern them
+        // moving or resizing only touches position and size, everything else is a full update
+        enum Changes : int
+        {
+            positionChanged = 1 << 0,
+            sizeChanged = 1 << 1,
+            propertiesChanged = 1 << 2,
+            colorsChanged = 1 << 3,
+            accessibilityChanged = 1 << 4,
+            timingsChanged = 1 << 5,
+            everythingChanged = positionChanged | sizeChanged | propertiesChanged | colorsChanged | accessibilityChanged | timingsChanged
+        };
+
         class Listener
         {
         public:
             virtual ~Listener() = default;
-            virtual void componentModelChanged (ComponentModel& model) = 0;
+            virtual void componentModelChanged (ComponentModel& model, int changes) = 0;
         };
 
         juce::Value nameValue;
@@ -22,7 +36,12 @@ namespace melatonin
         juce::Value visibleValue, wantsFocusValue, interceptsMouseValue, childrenInterceptsMouseValue;
         juce::Value lookAndFeelValue, typeValue, fontValue, alphaValue;
         juce::Value pickedColor;
-        juce::Value timing1, timing2, timing3, timingMax, hasChildren;
+        juce::Value hasChildren;
+        juce::Value repaintRateValue;
+        juce::Value overdrawValue;
+
+        // rendering the selected component's overdraw isn't free, so it's opt in
+        bool showOverdraw = false;
 
         juce::Value isToggleable, toggleState, clickTogglesState, radioGroupId;
 
@@ -31,7 +50,7 @@ namespace melatonin
             juce::Value title, value, role, handlerType;
         } accessiblityDetail;
 
-        double timingWithChildren1, timingWithChildren2, timingWithChildren3, timingWithChildrenMax;
+        TimingHistogram::Summary timing, timingWithChildren;
 
         ComponentModel() = default;
 
@@ -56,6 +75,13 @@ namespace melatonin
             updateModel();
         }
 
+        // coalesce moves and resizes into one notification per frame of this component's display
+        // without it, listeners are notified on every move, which can happen many times a frame
+        void coalesceOnVBlankOf (juce::Component& component)
+        {
+            vBlankCallback = { &component, [this] { flushPendingChanges(); } };
+        }
+
         void deselectComponent()
         {
             TRACE_COMPONENT();
@@ -105,12 +131,44 @@ namespace melatonin
 
         [[nodiscard]] bool hasPerformanceTiming()
         {
-            return timing1.getValue().isDouble();
+            return timing.count > 0;
+        }
+
+        // repaints are only counted with automatic timings on
+        [[nodiscard]] bool hasRepaintRate()
+        {
+            return selectedComponent != nullptr && TimingShim::isShim (selectedComponent->getCachedComponentImage());
+        }
+
+        // called when the automatic timings sample, cheaper than a full refresh
+        void updateTimings()
+        {
+            if (!selectedComponent)
+                return;
+
+            populatePerformanceData();
+            updateRepaintRate();
+            notifyListeners (timingsChanged);
+        }
+
+        void updateRepaintRate()
+        {
+            auto* entry = TimingTable::getInstance().find (selectedComponent);
+            if (entry == nullptr)
+            {
+                repaintRateValue = "0/s";
+                return;
+            }
+
+            repaintRateValue = juce::String (juce::roundToInt (entry->repaintsPerSecond)) + "/s, "
+                               + juce::String (entry->repaintedPixelsPerSecond / 1000000.0f, 2) + " Mpx/s";
         }
 
     private:
         juce::ListenerList<Listener> listenerList;
         juce::Component::SafePointer<juce::Component> selectedComponent;
+        juce::VBlankAttachment vBlankCallback;
+        int pendingChanges = 0;
 
         void updateModel()
         {
@@ -118,15 +176,22 @@ namespace melatonin
 
             removeListeners();
 
+            // a full update covers anything still waiting for the vblank
+            pendingChanges = 0;
+
             // always show picked color, even with no component selected
+            size_t numColors = 0;
             if (!pickedColor.getValue().isVoid())
-                colors.emplace_back ("Last Picked", pickedColor);
+                setNamedProperty (colors, numColors++, "Last Picked", pickedColor);
 
             if (!selectedComponent)
             {
+                colors.resize (numColors);
+                namedProperties.clear();
+
                 // if not manually removed, it'll linger in the model...
                 removePerformanceData();
-                notifyListeners();
+                notifyListeners (everythingChanged);
                 return;
             }
 
@@ -138,7 +203,9 @@ namespace melatonin
             opaqueValue = selectedComponent->isOpaque();
             wantsFocusValue = selectedComponent->getWantsKeyboardFocus();
             fontValue = componentFontValue (selectedComponent);
-            hasCachedImageValue = selectedComponent->getCachedComponentImage() != nullptr;
+            // the automatic timing shim doesn't cache anything
+            auto cachedImage = selectedComponent->getCachedComponentImage();
+            hasCachedImageValue = cachedImage != nullptr && !TimingShim::isShim (cachedImage);
             typeValue = type (*selectedComponent);
             accessibilityHandledValue = selectedComponent->isAccessible();
 
@@ -237,17 +304,21 @@ namespace melatonin
             }
 
             hasChildren.setValue (selectedComponent->getNumChildComponents() > 0);
-            populatePerformanceData (selectedComponent->getProperties());
+            populatePerformanceData();
+            updateRepaintRate();
 
             {
+                size_t numNamedProperties = 0;
                 auto& properties = selectedComponent->getProperties();
                 for (const auto& nv : properties)
                 {
                     if (nv.name.toString().startsWith ("jcclr_"))
-                        colors.emplace_back (nv.name.toString(), nv.value);
+                        setNamedProperty (colors, numColors++, nv.name.toString(), nv.value);
                     else
-                        namedProperties.emplace_back (nv.name.toString(), nv.value);
+                        setNamedProperty (namedProperties, numNamedProperties++, nv.name.toString(), nv.value);
                 }
+                colors.resize (numColors);
+                namedProperties.resize (numNamedProperties);
 
                 for (auto& nv : namedProperties)
                     nv.value.addListener (this);
@@ -255,7 +326,7 @@ namespace melatonin
                 for (auto& nv : colors)
                     nv.value.addListener (this);
             }
-            notifyListeners();
+            notifyListeners (everythingChanged);
         }
 
         void removeListeners()
@@ -285,9 +356,20 @@ namespace melatonin
 
             for (auto& np : colors)
                 np.value.removeListener (this);
+        }
 
-            colors.clear();
-            namedProperties.clear();
+        // when the property at this index has the same name, its Value is reused,
+        // so property editors stay bound to it and only need to refresh
+        static void setNamedProperty (std::vector<NamedProperty>& properties, size_t index, const juce::String& name, const juce::var& value)
+        {
+            if (index < properties.size() && properties[index].name == name)
+            {
+                properties[index].value = value;
+                return;
+            }
+
+            properties.resize (index);
+            properties.emplace_back (name, value);
         }
 
         // allows properties to be set from our properties
@@ -363,12 +445,20 @@ namespace melatonin
                 }
                 else
                 {
+                    // reused values also notify when the model updates them, which needs no write back
+                    auto writeBack = [this] (const NamedProperty& nv) {
+                        if (selectedComponent->getProperties()[nv.name] == nv.value.getValue())
+                            return;
+
+                        selectedComponent->getProperties().set (nv.name, nv.value.getValue());
+                        selectedComponent->repaint();
+                    };
+
                     for (auto& nv : namedProperties)
                     {
                         if (value.refersToSameSourceAs (nv.value))
                         {
-                            selectedComponent->getProperties().set (nv.name, nv.value.getValue());
-                            selectedComponent->repaint();
+                            writeBack (nv);
                             break;
                         }
                     }
@@ -377,8 +467,7 @@ namespace melatonin
                     {
                         if (value.refersToSameSourceAs (nv.value))
                         {
-                            selectedComponent->getProperties().set (nv.name, nv.value.getValue());
-                            selectedComponent->repaint();
+                            writeBack (nv);
                             break;
                         }
                     }
@@ -386,31 +475,38 @@ namespace melatonin
             }
         }
 
+        // called for every pixel of a drag or animation, so only bounds are updated
         void componentMovedOrResized (juce::Component&, bool wasMoved, bool wasResized) override
         {
             TRACE_COMPONENT();
 
-            if (wasResized || wasMoved)
-            {
-                updateModel();
-            }
+            pendingChanges |= (wasMoved ? positionChanged : 0) | (wasResized ? sizeChanged : 0);
+
+            if (vBlankCallback.isEmpty())
+                flushPendingChanges();
         }
 
-        void populatePerformanceData (const juce::NamedValueSet& props)
+        void flushPendingChanges()
         {
-            if (props.contains ("timing1"))
+            if (pendingChanges == 0 || !selectedComponent)
+                return;
+
+            TRACE_COMPONENT();
+
+            // an animating component keeps painting, so its timings go along with the bounds
+            populatePerformanceData();
+
+            auto changes = std::exchange (pendingChanges, 0) | timingsChanged;
+            notifyListeners (changes);
+        }
+
+        void populatePerformanceData()
+        {
+            auto* entry = TimingTable::getInstance().find (selectedComponent);
+            if (entry != nullptr && entry->exclusive.getCount() > 0)
             {
-                // assume they are all there
-                timing1 = props["timing1"];
-                timing2 = props["timing2"];
-                timing3 = props["timing3"];
-                timingMax = props["timingMax"];
-
-                timingWithChildren1 = timing1.getValue();
-                timingWithChildren2 = timing2.getValue();
-                timingWithChildren3 = timing3.getValue();
-                timingWithChildrenMax = timingMax.getValue();
-                getTimingWithChildren (selectedComponent);
+                timing = entry->exclusive.summarize();
+                timingWithChildren = entry->inclusive.summarize();
             }
             else
             {
@@ -418,38 +514,17 @@ namespace melatonin
             }
         }
 
-        void notifyListeners()
+        void notifyListeners (int changes)
         {
-            listenerList.call ([this] (Listener& listener) {
-                listener.componentModelChanged (*this);
+            listenerList.call ([this, changes] (Listener& listener) {
+                listener.componentModelChanged (*this, changes);
             });
         }
 
         void removePerformanceData()
         {
-            timing1 = juce::var();
-            timing2 = juce::var();
-            timing3 = juce::var();
-            timingMax = juce::var();
-            timingWithChildren1 = juce::var();
-            timingWithChildren2 = juce::var();
-            timingWithChildren3 = juce::var();
-            timingWithChildrenMax = juce::var();
-        }
-
-        void getTimingWithChildren (juce::Component* component)
-        {
-            for (auto child : component->getChildren())
-            {
-                if (child->getProperties().contains ("timing1"))
-                {
-                    timingWithChildren1 += (double) child->getProperties()["timing1"];
-                    timingWithChildren2 += (double) child->getProperties()["timing2"];
-                    timingWithChildren3 += (double) child->getProperties()["timing3"];
-                    timingWithChildrenMax += (double) child->getProperties()["timingMax"];
-                    getTimingWithChildren (child);
-                }
-            }
+            timing = {};
+            timingWithChildren = {};
         }
     };
 }
@@ -18,11 +18,17 @@ namespace melatonin
             model.removeListener (*this);
         }
 
+        // the rows are bound to the model's Values, which update in place
         void updateProperties()
         {
+            auto hasSelection = model.getSelectedComponent() != nullptr;
+            if (hasSelection == showingRows)
+                return;
+
+            showingRows = hasSelection;
             panel.clear();
 
-            if (!model.getSelectedComponent())
+            if (!hasSelection)
                 return;
 
             auto& ad = model.accessiblityDetail;
@@ -43,9 +49,10 @@ namespace melatonin
     protected:
         ComponentModel& model;
 
-        void componentModelChanged (ComponentModel&) override
+        void componentModelChanged (ComponentModel&, int changes) override
         {
-            updateProperties();
+            if (changes & ComponentModel::accessibilityChanged)
+                updateProperties();
         }
 
         void resized() override
@@ -56,6 +63,7 @@ namespace melatonin
         }
 
         int padding { 3 };
+        bool showingRows = false;
 
         juce::PropertyPanel panel { "Accessibility" };
     };
@@ -217,8 +217,11 @@ namespace melatonin
             }
         }
 
-        void componentModelChanged (ComponentModel&) override
+        void componentModelChanged (ComponentModel&, int changes) override
         {
+            if (!(changes & (ComponentModel::positionChanged | ComponentModel::sizeChanged)))
+                return;
+
             updateLabels();
             updatePaddingLabelsIfNeeded();
         }
@@ -11,7 +11,7 @@ namespace melatonin
     class CollapsablePanel : public juce::Component
     {
     public:
-        explicit CollapsablePanel (juce::String n, juce::Component* c, bool d = false) : name (std::move (n)), drawTopDivider (d), content (c)
+        explicit CollapsablePanel (juce::String n, juce::Component* c, bool d = false, bool o = true) : name (std::move (n)), drawTopDivider (d), openByDefault (o), content (c)
         {
             toggleButton.setLookAndFeel (&toggleButtonLookAndFeel);
             addAndMakeVisible (toggleButton);
@@ -43,7 +43,7 @@ namespace melatonin
         void visibilityChanged() override
         {
             if (isVisible())
-                toggle (settings->props->getBoolValue (name, true));
+                toggle (settings->props->getBoolValue (name, openByDefault));
         }
 
         // called when panel is toggled or overall inspector is toggled
@@ -112,6 +112,7 @@ namespace melatonin
         juce::ToggleButton toggleButton;
         juce::String name;
         bool drawTopDivider;
+        bool openByDefault;
         Component::SafePointer<Component> content;
         juce::SharedResourcePointer<InspectorSettings> settings;
     };
@@ -74,7 +74,7 @@ namespace melatonin
             };
 
             // update color properties with the correct display format
-            rgbaToggle.onClick = [this]() { componentModelChanged (model); };
+            rgbaToggle.onClick = [this]() { componentModelChanged (model, ComponentModel::everythingChanged); };
         }
 
         ~ColorPicker() override
@@ -212,7 +212,7 @@ namespace melatonin
 
         void reset()
         {
-            componentModelChanged (model);
+            componentModelChanged (model, ComponentModel::everythingChanged);
         }
 
         // close the picker if we are hidden
@@ -230,6 +230,7 @@ namespace melatonin
         Preview& preview;
 
         juce::PropertyPanel panel { "Properties" };
+        juce::StringArray shownRows;
         InspectorImageButton colorPickerButton { "eyedropper", { 0, 6 }, true };
         juce::Rectangle<int> colorValueBounds;
         juce::Rectangle<int> panelBounds;
@@ -241,7 +242,11 @@ namespace melatonin
         bool mouseDownShouldOnlyFocus = false;
 
         juce::Colour selectedColor { juce::Colours::transparentBlack };
-        std::unique_ptr<juce::Image> croppedSnapshot;
+        juce::Image croppedSnapshot;
+
+        // a capture of the root, only rendered where it's stale and under the loupe
+        juce::Image rootCapture;
+        juce::RectangleList<int> staleArea;
         int snapshotRadiusWidth = 21; // defaults align with initial dimensions of preview
         int snapshotRadiusHeight = 3;
 
@@ -270,6 +275,7 @@ namespace melatonin
 
                 preview.switchToPreview();
                 selectedColor = juce::Colours::transparentBlack;
+                rootCapture = {};
             }
 
             // might need to resize the panel if we need to toggle paint timings
@@ -290,17 +296,17 @@ namespace melatonin
                 return;
 
             updateSnapshot (positionInRoot);
-            auto snapshotBounds = croppedSnapshot->getBounds();
-            selectedColor = croppedSnapshot->getPixelAt (snapshotBounds.getCentreX(), snapshotBounds.getCentreY());
+            auto snapshotBounds = croppedSnapshot.getBounds();
+            selectedColor = croppedSnapshot.getPixelAt (snapshotBounds.getCentreX(), snapshotBounds.getCentreY());
 
             // our snapshotted image will be larger than the preview panel (due to the bleed)
-            preview.setZoomedImage (*croppedSnapshot);
+            preview.setZoomedImage (croppedSnapshot);
             repaint();
         }
 
         // we continually update a cropped snapshot when picking
-        // this avoids a big cumbersome whole-plugin snapshot (bad for perf)
-        // but still lets users navigate the UI (changing tabs, popups, etc)
+        // it's copied out of a capture of the root, so moving the mouse over parts that haven't repainted doesn't render anything
+        // repainted parts are rendered again when the loupe is over them, so users can still navigate the UI (changing tabs, popups, etc)
         void updateSnapshot (juce::Point<int> positionInRoot)
         {
             TRACE_COMPONENT();
@@ -309,7 +315,70 @@ namespace melatonin
                 return;
 
             auto snappedBounds = juce::Rectangle<int> (positionInRoot.x - snapshotRadiusWidth, positionInRoot.y - snapshotRadiusHeight, snapshotRadiusWidth * 2 + 1, snapshotRadiusHeight * 2 + 1);
-            croppedSnapshot = std::make_unique<juce::Image> (root->createComponentSnapshot (snappedBounds, false));
+            if (croppedSnapshot.getBounds() != snappedBounds.withZeroOrigin())
+                croppedSnapshot = juce::Image (juce::Image::ARGB, snappedBounds.getWidth(), snappedBounds.getHeight(), true);
+            else
+                croppedSnapshot.clear (croppedSnapshot.getBounds());
+
+            // near the edges, the rest stays transparent
+            auto area = snappedBounds.getIntersection (root->getLocalBounds());
+            if (area.isEmpty())
+                return;
+
+            updateRootCapture (area);
+            copyToSnapshot (rootCapture, area, area.getPosition() - snappedBounds.getPosition());
+        }
+
+        void updateRootCapture (juce::Rectangle<int> loupeArea)
+        {
+            // the root's shim tells us what repainted since last time
+            // an app's own cached image on the root hides that, so the area under the loupe is always stale
+            auto dirtyArea = TimingShim::takeDirtyArea (*root);
+
+            if (rootCapture.getBounds() != root->getLocalBounds())
+            {
+                rootCapture = juce::Image (juce::Image::ARGB, root->getWidth(), root->getHeight(), true);
+                staleArea.clear();
+                staleArea.add (root->getLocalBounds());
+            }
+            else
+            {
+                staleArea.add (dirtyArea.value_or (loupeArea));
+            }
+
+            auto renderArea = staleArea.getBounds().getIntersection (loupeArea);
+            if (!staleArea.intersects (renderArea))
+                return;
+
+            render (renderArea);
+            staleArea.subtract (renderArea);
+        }
+
+        // renders straight into the capture, like createComponentSnapshot does
+        void render (juce::Rectangle<int> area)
+        {
+            TRACE_COMPONENT();
+
+            // our render shouldn't show up in timings, or include the inspector's own components
+            ScopedTimingPause pause;
+            TimingShim::ScopedHideInspector hideInspector;
+
+            rootCapture.clear (area);
+            juce::Graphics g (rootCapture);
+            g.reduceClipRegion (area);
+            root->paintEntireComponent (g, true);
+        }
+
+        void copyToSnapshot (const juce::Image& image, juce::Rectangle<int> area, juce::Point<int> destinationPosition)
+        {
+            area = area.getIntersection (image.getBounds());
+            if (area.isEmpty())
+                return;
+
+            juce::Image::BitmapData source (image, area.getX(), area.getY(), area.getWidth(), area.getHeight(), juce::Image::BitmapData::readOnly);
+            juce::Image::BitmapData destination (croppedSnapshot, destinationPosition.x, destinationPosition.y, area.getWidth(), area.getHeight(), juce::Image::BitmapData::writeOnly);
+            for (int y = 0; y < area.getHeight(); ++y)
+                std::memcpy (destination.getLinePointer (y), source.getLinePointer (y), (size_t) (area.getWidth() * source.pixelStride));
         }
 
         void updateSnapshotDimensions()
@@ -340,10 +409,22 @@ namespace melatonin
             jassert (snapshotRadiusHeight == 3);
         }
 
-        void componentModelChanged (ComponentModel&) override
+        void componentModelChanged (ComponentModel&, int changes) override
         {
             TRACE_COMPONENT();
 
+            if (!(changes & ComponentModel::colorsChanged))
+                return;
+
+            // the model reuses its Values, so only rebuild when the rows change
+            juce::StringArray rows { rgbaToggle.rgba ? "rgba" : "hex" };
+            for (auto& nv : model.colors)
+                rows.add (nv.name);
+
+            if (rows == shownRows)
+                return;
+
+            shownRows = rows;
             panel.clear();
             juce::Array<juce::PropertyComponent*> props;
 
@@ -1,4 +1,5 @@
 #pragma once
+#include "melatonin_inspector/melatonin/helpers/timing_table.h"
 
 namespace melatonin
 {
@@ -132,7 +133,15 @@ namespace melatonin
 
             g.setFont (font);
 
-            g.drawText (name, textIndent, itemArea.getY(), w - textIndent, itemArea.getHeight(), juce::Justification::left, true);
+            g.drawText (name, textIndent, itemArea.getY(), w - textIndent - repaintRateWidth, itemArea.getHeight(), juce::Justification::left, true);
+
+            // repaints per second, only known with automatic timings on
+            if (repaintRate >= 1.0f)
+            {
+                g.setColour (repaintRate >= 30.0f ? colors::propertyValueWarn : colors::treeItemTextDisabled);
+                g.setFont (InspectorLookAndFeel::getInspectorFont (13, juce::Font::FontStyleFlags::plain));
+                g.drawText (juce::String (juce::roundToInt (repaintRate)) + "/s", w - repaintRateWidth, itemArea.getY(), repaintRateWidth - 8, itemArea.getHeight(), juce::Justification::right, false);
+            }
         }
 
         // must override to set the disclosure triangle color
@@ -288,6 +297,29 @@ namespace melatonin
             return res;
         }
 
+        // refreshes the repaint rate column, optionally putting the busiest branches on top
+        // returns the highest repaint rate in this branch
+        float updateRepaintRates (bool sortByRepaintRate)
+        {
+            auto* entry = TimingTable::getInstance().find (component);
+            repaintRate = entry != nullptr ? entry->repaintsPerSecond : 0.0f;
+            branchRepaintRate = repaintRate;
+
+            for (int i = 0; i < getNumSubItems(); ++i)
+                if (auto* item = dynamic_cast<ComponentTreeViewItem*> (getSubItem (i)))
+                    branchRepaintRate = juce::jmax (branchRepaintRate, item->updateRepaintRates (sortByRepaintRate));
+
+            // only re-sort when needed, as it invalidates the tree layout
+            if (sortByRepaintRate || sortedByRepaintRate)
+            {
+                ItemSorter sorter { sortByRepaintRate };
+                sortSubItems (sorter);
+                sortedByRepaintRate = sortByRepaintRate;
+            }
+
+            return branchRepaintRate;
+        }
+
         int getItemHeight() const override
         {
             auto normalItemHeight = 28;
@@ -306,12 +338,40 @@ namespace melatonin
         bool selectable = false;
         juce::Rectangle<float> disclosureRect;
 
+        constexpr static int repaintRateWidth = 48;
+        float repaintRate = 0;
+        float branchRepaintRate = 0;
+        bool sortedByRepaintRate = false;
+
+        // lets us go back to component order after sorting
+        int originalIndex = 0;
+
+        struct ItemSorter
+        {
+            bool byRepaintRate;
+
+            int compareElements (juce::TreeViewItem* first, juce::TreeViewItem* second) const
+            {
+                auto a = dynamic_cast<ComponentTreeViewItem*> (first);
+                auto b = dynamic_cast<ComponentTreeViewItem*> (second);
+
+                if (byRepaintRate && !juce::approximatelyEqual (a->branchRepaintRate, b->branchRepaintRate))
+                    return a->branchRepaintRate > b->branchRepaintRate ? -1 : 1;
+
+                return a->originalIndex - b->originalIndex;
+            }
+        };
+
         void recursivelyAddChildrenFor (juce::Component* child)
         {
             // Components such as Labels can have a nullptr component child
             // Rather than display empty placeholders in the tree view, we will hide them
             if (child)
-                addSubItem (new ComponentTreeViewItem (child, outlineComponentCallback, selectComponentCallback));
+            {
+                auto item = new ComponentTreeViewItem (child, outlineComponentCallback, selectComponentCallback);
+                item->originalIndex = getNumSubItems();
+                addSubItem (item);
+            }
         }
 
         void addItemsForChildComponents()
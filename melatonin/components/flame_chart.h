@@ -0,0 +1,296 @@
+#pragma once
+
+#include "melatonin_inspector/melatonin/components/pill_toggle.h"
+#include "melatonin_inspector/melatonin/helpers/component_helpers.h"
+#include "melatonin_inspector/melatonin/helpers/timing.h"
+
+namespace melatonin
+{
+    /*
+     * Shows the timed paints of recent frames as a flame chart.
+     *
+     * The strip on top has one bar per frame, click one to freeze on it.
+     * WORST pins the slowest frame seen so far.
+     * Scroll to zoom, drag to pan, double click to zoom back out.
+     * Click a span to select its component.
+     */
+    class FlameChart : public juce::Component, private juce::Timer
+    {
+    public:
+        std::function<void (juce::Component*)> selectComponentCallback;
+
+        static constexpr double budgetMs = 1000.0 / 60.0;
+
+        FlameChart()
+        {
+            addAndMakeVisible (worstToggle);
+            addAndMakeVisible (liveToggle);
+
+            liveToggle.on = true;
+            liveToggle.onClick = [this] { setMode (live); };
+            worstToggle.onClick = [this] { setMode (worstToggle.on ? worst : live); };
+        }
+
+        ~FlameChart() override
+        {
+            FrameRecorder::getInstance().setEnabled (false);
+        }
+
+        void paint (juce::Graphics& g) override
+        {
+            TRACE_COMPONENT();
+
+            g.setColour (colors::black);
+            g.fillRect (chartBounds);
+
+            drawFrameStrip (g);
+            drawChart (g);
+        }
+
+        void resized() override
+        {
+            auto area = getLocalBounds().reduced (0, 4);
+            auto top = area.removeFromTop (stripHeight);
+            liveToggle.setBounds (top.removeFromLeft (44));
+            worstToggle.setBounds (top.removeFromLeft (50));
+            stripBounds = top.withTrimmedLeft (4);
+
+            area.removeFromTop (4);
+            chartBounds = area;
+        }
+
+        // only record while someone is looking
+        void visibilityChanged() override
+        {
+            FrameRecorder::getInstance().setEnabled (isVisible());
+
+            if (isVisible())
+                startTimerHz (10);
+            else
+                stopTimer();
+        }
+
+        void mouseDown (const juce::MouseEvent& e) override
+        {
+            dragStartViewMs = viewStartMs;
+
+            // freeze on a frame from the strip
+            if (stripBounds.contains (e.getPosition()))
+            {
+                auto framesAgo = (size_t) ((stripBounds.getRight() - e.x) / barWidth);
+                if (framesAgo < FrameRecorder::getInstance().getNumFrames())
+                {
+                    setMode (frozen);
+                    showFrame (FrameRecorder::getInstance().getFrame (framesAgo));
+                }
+            }
+        }
+
+        void mouseDrag (const juce::MouseEvent& e) override
+        {
+            if (!chartBounds.contains (e.getMouseDownPosition()))
+                return;
+
+            auto span = viewEndMs - viewStartMs;
+            viewStartMs = dragStartViewMs - (double) e.getDistanceFromDragStartX() / chartBounds.getWidth() * span;
+            viewEndMs = viewStartMs + span;
+            repaint();
+        }
+
+        void mouseUp (const juce::MouseEvent& e) override
+        {
+            if (e.mouseWasDraggedSinceMouseDown() || !chartBounds.contains (e.getPosition()))
+                return;
+
+            if (auto* span = spanAt (e.getPosition()))
+                if (auto* entry = TimingTable::getInstance().find (span->component); entry != nullptr && selectComponentCallback)
+                    selectComponentCallback (entry->component);
+        }
+
+        void mouseDoubleClick (const juce::MouseEvent&) override
+        {
+            resetZoom();
+        }
+
+        void mouseWheelMove (const juce::MouseEvent& e, const juce::MouseWheelDetails& wheel) override
+        {
+            if (!chartBounds.contains (e.getPosition()))
+                return;
+
+            // zoom around the mouse
+            auto mouseMs = xToMs ((float) e.x);
+            auto factor = std::pow (0.8, wheel.deltaY * 4.0);
+            viewStartMs = mouseMs - (mouseMs - viewStartMs) * factor;
+            viewEndMs = mouseMs + (viewEndMs - mouseMs) * factor;
+            repaint();
+        }
+
+    private:
+        enum Mode { live, frozen, worst } mode = live;
+
+        PillToggle liveToggle { "LIVE" };
+        PillToggle worstToggle { "WORST" };
+
+        static constexpr int stripHeight = 32;
+        static constexpr int barWidth = 3;
+        static constexpr int rowHeight = 16;
+
+        juce::Rectangle<int> stripBounds, chartBounds;
+
+        std::vector<FrameRecorder::Span> spans;
+        FrameRecorder::Frame frame;
+
+        double viewStartMs = 0;
+        double viewEndMs = budgetMs;
+        double dragStartViewMs = 0;
+
+        void setMode (Mode newMode)
+        {
+            mode = newMode;
+            liveToggle.on = mode == live;
+            worstToggle.on = mode == worst;
+            liveToggle.repaint();
+            worstToggle.repaint();
+
+            if (mode == worst)
+            {
+                auto& recorder = FrameRecorder::getInstance();
+                frame = recorder.getWorstFrame();
+                spans = recorder.getWorstSpans();
+                resetZoom();
+            }
+
+            repaint();
+        }
+
+        void timerCallback() override
+        {
+            auto& recorder = FrameRecorder::getInstance();
+
+            if (mode == live && recorder.getNumFrames() > 0)
+                showFrame (recorder.getFrame (0));
+
+            repaint();
+        }
+
+        void showFrame (const FrameRecorder::Frame& newFrame)
+        {
+            frame = newFrame;
+            if (!FrameRecorder::getInstance().copySpans (frame, spans))
+                frame = {};
+
+            // live keeps whatever zoom the user picked
+            if (mode != live)
+                resetZoom();
+        }
+
+        void resetZoom()
+        {
+            viewStartMs = 0;
+            viewEndMs = juce::jmax (frame.getDurationMs(), budgetMs) * 1.05;
+            repaint();
+        }
+
+        [[nodiscard]] float msToX (double ms) const
+        {
+            return (float) chartBounds.getX() + (float) ((ms - viewStartMs) / (viewEndMs - viewStartMs) * chartBounds.getWidth());
+        }
+
+        [[nodiscard]] double xToMs (float x) const
+        {
+            return viewStartMs + (double) (x - (float) chartBounds.getX()) / chartBounds.getWidth() * (viewEndMs - viewStartMs);
+        }
+
+        [[nodiscard]] juce::Rectangle<float> getSpanBounds (const FrameRecorder::Span& span, bool ownOnly = false) const
+        {
+            auto start = FrameRecorder::ticksToMs (span.startTicks - frame.startTicks);
+            auto end = FrameRecorder::ticksToMs ((ownOnly ? span.ownEndTicks : span.endTicks) - frame.startTicks);
+            auto x = msToX (start);
+            auto y = (float) (chartBounds.getY() + (int) span.depth * rowHeight);
+            return { x, y, juce::jmax (1.0f, msToX (end) - x), (float) rowHeight - 1.0f };
+        }
+
+        const FrameRecorder::Span* spanAt (juce::Point<int> position) const
+        {
+            for (auto& span : spans)
+                if (getSpanBounds (span).contains (position.toFloat()))
+                    return &span;
+
+            return nullptr;
+        }
+
+        void drawFrameStrip (juce::Graphics& g)
+        {
+            auto& recorder = FrameRecorder::getInstance();
+            auto worstMs = juce::jmax (recorder.getWorstFrame().getDurationMs(), budgetMs);
+            auto numBars = juce::jmin (recorder.getNumFrames(), (size_t) (stripBounds.getWidth() / barWidth));
+
+            // newest on the right
+            for (size_t i = 0; i < numBars; ++i)
+            {
+                auto& f = recorder.getFrame (i);
+                auto ms = f.getDurationMs();
+                auto height = juce::jmax (1.0f, (float) (ms / worstMs) * (float) stripBounds.getHeight());
+                auto x = (float) (stripBounds.getRight() - (int) (i + 1) * barWidth);
+
+                auto isShown = mode != live && f.firstSpan == frame.firstSpan;
+                g.setColour (isShown ? colors::highlight : (ms > budgetMs ? colors::propertyValueError : colors::text));
+                g.fillRect (x, (float) stripBounds.getBottom() - height, (float) barWidth - 1.0f, height);
+            }
+
+            // the 60fps budget
+            auto budgetY = (float) stripBounds.getBottom() - (float) (budgetMs / worstMs) * (float) stripBounds.getHeight();
+            g.setColour (colors::propertyValueWarn.withAlpha (0.5f));
+            g.drawHorizontalLine ((int) budgetY, (float) stripBounds.getX(), (float) stripBounds.getRight());
+        }
+
+        void drawChart (juce::Graphics& g)
+        {
+            juce::Graphics::ScopedSaveState state (g);
+            g.reduceClipRegion (chartBounds);
+
+            if (spans.empty())
+            {
+                g.setColour (colors::propertyValueDisabled);
+                g.setFont (InspectorLookAndFeel::getInspectorFont (14, juce::Font::FontStyleFlags::plain));
+                g.drawText ("Waiting for timed paints...", chartBounds, juce::Justification::centred);
+                return;
+            }
+
+            g.setFont (InspectorLookAndFeel::getInspectorFont (11, juce::Font::FontStyleFlags::plain));
+
+            for (auto& span : spans)
+            {
+                auto bounds = getSpanBounds (span);
+                if (bounds.getRight() < (float) chartBounds.getX() || bounds.getX() > (float) chartBounds.getRight())
+                    continue;
+
+                // the lighter tail is time spent in timed descendants after our own paint
+                g.setColour (colors::overlayBoundingBox.withAlpha (0.4f));
+                g.fillRect (bounds);
+                g.setColour (colors::overlayBoundingBox);
+                g.fillRect (getSpanBounds (span, true));
+
+                if (bounds.getWidth() > 30)
+                {
+                    auto* entry = TimingTable::getInstance().find (span.component);
+                    auto name = entry != nullptr ? componentString (entry->component) : juce::String ("(deleted)");
+                    auto ms = FrameRecorder::ticksToMs (span.endTicks - span.startTicks);
+
+                    g.setColour (colors::white);
+                    g.drawText (name + " " + juce::String (ms, 2) + "ms", bounds.reduced (3, 0), juce::Justification::centredLeft, true);
+                }
+            }
+
+            // the 60fps budget
+            g.setColour (colors::propertyValueError);
+            g.drawVerticalLine ((int) msToX (budgetMs), (float) chartBounds.getY(), (float) chartBounds.getBottom());
+
+            g.setColour (colors::propertyValueDisabled);
+            auto label = juce::String (frame.getDurationMs(), 2) + "ms, " + juce::String (spans.size()) + " paints";
+            g.drawText (label, chartBounds.reduced (4), juce::Justification::bottomRight);
+        }
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FlameChart)
+    };
+}
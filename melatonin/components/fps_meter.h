@@ -1,6 +1,9 @@
 #pragma once
 #include "juce_gui_basics/juce_gui_basics.h"
 #include "melatonin_inspector/melatonin/helpers/colors.h"
+#include "melatonin_inspector/melatonin/helpers/component_helpers.h"
+#include "melatonin_inspector/melatonin/helpers/frame_intervals.h"
+#include "melatonin_inspector/melatonin/helpers/timing_table.h"
 
 // VBlank was added in 7.0.3
 #if (JUCE_MAJOR_VERSION >= 7) && (JUCE_MINOR_VERSION >= 1 || JUCE_BUILDNUMBER >= 3)
@@ -16,6 +19,11 @@ namespace melatonin
     class FPSMeter : public juce::Component, private juce::Timer
     {
     public:
+        // stats cover this many seconds of frames
+        static constexpr double windowSeconds = 5.0;
+
+        enum class Corner { topLeft, topRight, bottomLeft, bottomRight };
+
         FPSMeter ()
         {
             // don't repaint the parent
@@ -24,24 +32,76 @@ namespace melatonin
             setOpaque (true);
 
             setInterceptsMouseClicks (false, false);
+
+            // the probe sits right below us, so our own repaints are clipped away from it
+            setAlwaysOnTop (true);
+            probe.onPaint = [this] { update(); };
         }
 
         void setRoot (juce::Component& o)
         {
             overlay = &o;
 
+            overlay->addChildComponent (probe);
             overlay->addChildComponent (this);
         }
 
         void clearRoot()
         {
             if (overlay)
+            {
+                overlay->removeChildComponent (&probe);
                 overlay->removeChildComponent (this);
+            }
+        }
+
+        // Passive measurement timestamps the root's real paint passes instead of forcing one every vblank
+        // The meter itself then only redraws a few times a second
+        // Gaps longer than idleGapMs are the UI being idle, so they're counted separately and aren't frames
+        void setPassive (bool shouldBePassive)
+        {
+            passive = shouldBePassive;
+            visibilityChanged();
+        }
+
+        [[nodiscard]] bool isPassive() const noexcept { return passive; }
+
+        // the automatic timings shouldn't time it
+        juce::Component& getPaintProbe() noexcept { return probe; }
+
+        // the HUD adds a frame time sparkline and the components with the most expensive paints
+        void setHUD (bool shouldShowHUD, Corner newCorner)
+        {
+            hud = shouldShowHUD;
+            corner = newCorner;
+            updateBounds();
+            repaint();
+        }
+
+        [[nodiscard]] bool isHUD() const noexcept { return hud; }
+
+        // docks us in our corner of the root
+        void updateBounds()
+        {
+            if (overlay == nullptr)
+                return;
+
+            auto area = overlay->getLocalBounds();
+            auto width = hud ? hudWidth : 84;
+            auto height = hud ? hudHeight : 40;
+            auto isLeft = corner == Corner::topLeft || corner == Corner::bottomLeft;
+            auto isTop = corner == Corner::topLeft || corner == Corner::topRight;
+            setBounds (isLeft ? area.getX() : area.getRight() - width, isTop ? area.getY() : area.getBottom() - height, width, height);
+            probe.setBounds (area);
         }
 
         void timerCallback() override
         {
             TRACE_EVENT ("component", "fps timer callback");
+
+            if (passive && !juce::approximatelyEqual (lastTime, 0.0))
+                idle = juce::Time::getMillisecondCounterHiRes() - lastTime > idleGapMs;
+
             repaint();
         }
 
@@ -50,8 +110,22 @@ namespace melatonin
             frameTime = 0;
             lastTime = 0;
             fps = 0;
-            if (isVisible())
+            intervals.clear();
+            stats = {};
+            idle = false;
+            idleGaps = 0;
+            probe.setVisible (passive && isVisible());
+
+            if (isVisible() && passive)
             {
+#if MELATONIN_VBLANK
+                vBlankCallback = {};
+#endif
+                startTimerHz (4);
+            }
+            else if (isVisible())
+            {
+                stopTimer();
 #if MELATONIN_VBLANK
                 // right before every paint, call repaint
                 // syncs to ensure each paint call is preceded by a recalculation
@@ -70,9 +144,8 @@ namespace melatonin
             {
 #if MELATONIN_VBLANK
                 vBlankCallback = {};
-#else
-                stopTimer();
 #endif
+                stopTimer();
             }
         }
 
@@ -80,17 +153,34 @@ namespace melatonin
         {
             TRACE_COMPONENT();
 
-            update();
+            if (!passive)
+                update();
 
             // tried to go for pixel font but didn't work :/
             g.setImageResamplingQuality (juce::Graphics::ResamplingQuality::lowResamplingQuality);
             g.setColour (colors::black);
             g.fillRect (getLocalBounds());
+
+            if (hud)
+            {
+                paintHUD (g);
+                return;
+            }
+
+            auto area = getLocalBounds().reduced (0, 3);
             g.setColour (juce::Colours::green);
             g.setFont (font);
-            g.drawText (juce::String (juce::String (fps) + " FPS"), getLocalBounds(), juce::Justification::centred, true);
+            g.drawText (getFPSText(), area.removeFromTop (area.getHeight() / 2 + 2), juce::Justification::centred, true);
+
+            // compact stats, red when a frame took longer than 2 vblanks at 60hz
+            g.setColour (stats.over30fpsBudget > 0 && !idle ? colors::propertyValueError : juce::Colours::green.darker());
+            g.setFont (smallFont);
+            g.drawText (getStatsText(), area, juce::Justification::centred, true);
         }
 
+        [[nodiscard]] const FrameIntervals::Stats& getStats() const noexcept { return stats; }
+        [[nodiscard]] const FrameIntervals& getIntervals() const noexcept { return intervals; }
+
         void update()
         {
             TRACE_COMPONENT();
@@ -104,6 +194,15 @@ namespace melatonin
                 return;
             }
 
+            // nothing repainted for a while, that's an idle UI and not a slow frame
+            if (passive && elapsed > idleGapMs)
+            {
+                ++idleGaps;
+                lastTime = now;
+                return;
+            }
+            idle = false;
+
             if (juce::approximatelyEqual (frameTime, 0.0))
             {
                 // start without any smoothing
@@ -118,22 +217,166 @@ namespace melatonin
             }
             lastTime = now;
             fps = juce::roundToInt (1000 / frameTime);
+
+            // the raw intervals, no smoothing
+            intervals.add (now, elapsed);
+            if (now - lastStatsTime > 250)
+            {
+                stats = intervals.getStats (now, windowSeconds * 1000);
+                lastStatsTime = now;
+            }
+
+            if (hud && now - lastOffendersTime > 1000)
+            {
+                updateOffenders();
+                lastOffendersTime = now;
+            }
         }
 
     private:
+        static constexpr int hudWidth = 220;
+        static constexpr int sparklineHeight = 40;
+        static constexpr int offenderRowHeight = 14;
+        static constexpr int hudHeight = 6 + 18 + sparklineHeight + 4 + 3 * offenderRowHeight + 6;
+
+        bool hud = false;
+        Corner corner = Corner::topRight;
+
+        // Covers the root and paints nothing
+        // Every paint pass that touches the root (outside of the opaque meter) calls its paint
+        // It can't be unclipped, as JUCE doesn't clip away opaque siblings for unclipped components
+        class PaintProbe : public juce::Component
+        {
+        public:
+            std::function<void()> onPaint;
+
+            PaintProbe()
+            {
+                setInterceptsMouseClicks (false, false);
+                setAlwaysOnTop (true);
+            }
+
+            void paint (juce::Graphics&) override
+            {
+                if (onPaint)
+                    onPaint();
+            }
+        };
+
+        bool passive = false;
+        PaintProbe probe;
+
+        // passive, we can't tell a long frame from nothing needing a repaint
+        // so anything longer than 2 vblanks at 60hz is treated as the latter
+        static constexpr double idleGapMs = 2 * FrameIntervals::budget60fps;
+        bool idle = false;
+        juce::uint64 idleGaps = 0;
+
+        // the sparkline path is reused, so painting doesn't allocate once it's grown
+        juce::Path sparkline;
+
+        std::array<const TimingTable::Entry*, 3> mostExpensive {};
+        std::array<juce::String, 3> offenderNames;
+        std::array<float, 3> offenderCosts {};
+        double lastOffendersTime = 0;
+
         juce::Component* overlay = nullptr;
         juce::Rectangle<int> bounds;
        #if JUCE_MAJOR_VERSION == 8
         juce::Font font = juce::FontOptions (juce::Font::getDefaultMonospacedFontName(), 16.0f, juce::Font::plain);
+        juce::Font smallFont = juce::FontOptions (juce::Font::getDefaultMonospacedFontName(), 11.0f, juce::Font::plain);
        #else
         juce::Font font = juce::Font (juce::Font::getDefaultMonospacedFontName(), 16.0f, juce::Font::plain);
+        juce::Font smallFont = juce::Font (juce::Font::getDefaultMonospacedFontName(), 11.0f, juce::Font::plain);
        #endif
         double lastTime = juce::Time::getMillisecondCounterHiRes();
         double frameTime = 0;
         int fps = 0;
 
+        FrameIntervals intervals;
+        FrameIntervals::Stats stats;
+        double lastStatsTime = 0;
+
 #if MELATONIN_VBLANK
         juce::VBlankAttachment vBlankCallback;
 #endif
+
+        [[nodiscard]] juce::String getFPSText() const
+        {
+            return idle ? juce::String ("IDLE") : juce::String (fps) + " FPS";
+        }
+
+        [[nodiscard]] juce::String getStatsText() const
+        {
+            if (idle)
+                return juce::String (idleGaps) + " idle gaps";
+
+            return "p99 " + juce::String (stats.p99, 1) + "ms";
+        }
+
+        // uses the timings of ComponentTimer or automatic timings
+        void updateOffenders()
+        {
+            auto& table = TimingTable::getInstance();
+            table.sample();
+            table.findMostExpensive (mostExpensive);
+
+            for (size_t i = 0; i < mostExpensive.size(); ++i)
+            {
+                auto* entry = mostExpensive[i];
+                offenderNames[i] = entry != nullptr ? componentString (entry->component.getComponent()) : juce::String();
+                offenderCosts[i] = entry != nullptr ? entry->paintMsPerSecond : 0.0f;
+            }
+        }
+
+        void paintHUD (juce::Graphics& g)
+        {
+            auto area = getLocalBounds().reduced (6);
+
+            auto header = area.removeFromTop (18);
+            g.setColour (juce::Colours::green);
+            g.setFont (font);
+            g.drawText (getFPSText(), header, juce::Justification::centredLeft, true);
+            g.setColour (stats.over30fpsBudget > 0 && !idle ? colors::propertyValueError : juce::Colours::green.darker());
+            g.setFont (smallFont);
+            g.drawText (getStatsText(), header, juce::Justification::centredRight, true);
+
+            // newest frame on the right, 33ms fills the height
+            auto graph = area.removeFromTop (sparklineHeight).toFloat();
+            auto toY = [&] (double intervalMs) {
+                return graph.getBottom() - (float) juce::jmin (1.0, intervalMs / FrameIntervals::budget30fps) * graph.getHeight();
+            };
+
+            g.setColour (colors::propertyValueWarn.withAlpha (0.5f));
+            g.drawHorizontalLine ((int) toY (FrameIntervals::budget60fps), graph.getX(), graph.getRight());
+
+            sparkline.clear();
+            auto numPoints = juce::jmin (intervals.size(), (size_t) (graph.getWidth() / 2));
+            for (size_t i = 0; i < numPoints; ++i)
+            {
+                auto x = graph.getRight() - (float) i * 2.0f;
+                auto y = toY (intervals.getInterval (i));
+                if (i == 0)
+                    sparkline.startNewSubPath (x, y);
+                else
+                    sparkline.lineTo (x, y);
+            }
+            g.setColour (juce::Colours::green);
+            g.strokePath (sparkline, juce::PathStrokeType (1.0f));
+
+            area.removeFromTop (4);
+            g.setFont (smallFont);
+            for (size_t i = 0; i < offenderNames.size(); ++i)
+            {
+                auto row = area.removeFromTop (offenderRowHeight);
+                if (offenderNames[i].isEmpty())
+                    continue;
+
+                g.setColour (colors::text);
+                g.drawText (juce::String (offenderCosts[i], 1) + "ms/s", row.removeFromRight (60), juce::Justification::centredRight, false);
+                g.setColour (colors::propertyValue);
+                g.drawText (offenderNames[i], row, juce::Justification::centredLeft, true);
+            }
+        }
     };
 }
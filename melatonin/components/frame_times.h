@@ -0,0 +1,206 @@
+#pragma once
+
+#include "melatonin_inspector/melatonin/components/fps_meter.h"
+#include "melatonin_inspector/melatonin/helpers/counters.h"
+#include "melatonin_inspector/melatonin/lookandfeel.h"
+
+namespace melatonin
+{
+    // The detailed view of the FPS meter's frame times
+    // plotted on a timeline along with melatonin::counter and melatonin::mark
+    class FrameTimes : public juce::Component, private juce::Timer
+    {
+    public:
+        static constexpr int rowHeight = 18;
+        static constexpr int numRows = 7;
+        static constexpr int graphHeight = 80;
+        static constexpr double timelineMs = 10000;
+
+        [[nodiscard]] static int getHeightNeeded()
+        {
+            return numRows * rowHeight + graphHeight + rowHeight + 20;
+        }
+
+        void setFPSMeter (FPSMeter* m)
+        {
+            meter = m;
+        }
+
+        void paint (juce::Graphics& g) override
+        {
+            TRACE_COMPONENT();
+
+            auto area = getLocalBounds().reduced (0, 6);
+
+            if (!isMeterRunning())
+            {
+                g.setColour (colors::propertyValueDisabled);
+                g.setFont (InspectorLookAndFeel::getInspectorFont (15, juce::Font::FontStyleFlags::plain));
+                g.drawText ("Turn on the FPS meter to record frame times", area.removeFromTop (rowHeight), juce::Justification::centredLeft);
+                area.removeFromTop ((numRows - 1) * rowHeight + 8);
+                drawTimeline (g, area.removeFromTop (graphHeight));
+                drawLegend (g, area.removeFromTop (rowHeight));
+                return;
+            }
+
+            auto& stats = meter->getStats();
+            auto over = [&] (size_t count) { return juce::String (count) + " of " + juce::String (stats.numFrames); };
+
+            g.setFont (InspectorLookAndFeel::getInspectorFont (15, juce::Font::FontStyleFlags::plain));
+            InspectorLookAndFeel::drawStatRow (g, area.removeFromTop (rowHeight), "FPS", juce::String (stats.fps, 1), false);
+            InspectorLookAndFeel::drawStatRow (g, area.removeFromTop (rowHeight), "p50", ms (stats.p50), stats.p50 > FrameIntervals::budget60fps);
+            InspectorLookAndFeel::drawStatRow (g, area.removeFromTop (rowHeight), "p95", ms (stats.p95), stats.p95 > FrameIntervals::budget60fps);
+            InspectorLookAndFeel::drawStatRow (g, area.removeFromTop (rowHeight), "p99", ms (stats.p99), stats.p99 > FrameIntervals::budget60fps);
+            InspectorLookAndFeel::drawStatRow (g, area.removeFromTop (rowHeight), "Over 16.7ms", over (stats.over60fpsBudget), stats.over60fpsBudget > 0);
+            InspectorLookAndFeel::drawStatRow (g, area.removeFromTop (rowHeight), "Over 33.3ms", over (stats.over30fpsBudget), stats.over30fpsBudget > 0);
+            InspectorLookAndFeel::drawStatRow (g, area.removeFromTop (rowHeight), "Longest Stall", ms (stats.longestStall), stats.longestStall > FrameIntervals::budget30fps);
+
+            area.removeFromTop (8);
+            drawTimeline (g, area.removeFromTop (graphHeight));
+            drawLegend (g, area.removeFromTop (rowHeight));
+        }
+
+    private:
+        FPSMeter* meter = nullptr;
+
+        void visibilityChanged() override
+        {
+            if (isVisible())
+                startTimerHz (4);
+            else
+                stopTimer();
+        }
+
+        void timerCallback() override
+        {
+            Counters::getInstance().drain();
+            repaint();
+        }
+
+        [[nodiscard]] bool isMeterRunning() const
+        {
+            return meter != nullptr && meter->isVisible();
+        }
+
+        static juce::Colour getSeriesColour (size_t index)
+        {
+            return juce::Colour::fromHSV ((float) index / (float) Counters::maxSeries + 0.3f, 0.6f, 1.0f, 1.0f);
+        }
+
+        static juce::String ms (double value)
+        {
+            return juce::String (value, 1) + "ms";
+        }
+
+        // the last 10 seconds, newest on the right
+        // frame times are bars scaled so 33ms fills the height, counters are scaled to their own range
+        void drawTimeline (juce::Graphics& g, juce::Rectangle<int> bounds) const
+        {
+            g.setColour (colors::black);
+            g.fillRect (bounds);
+
+            auto graph = bounds.toFloat();
+            auto nowMs = juce::Time::getMillisecondCounterHiRes();
+            auto toX = [&] (double ms) { return graph.getRight() - (float) ((nowMs - ms) / timelineMs) * graph.getWidth(); };
+            auto toHeight = [&] (double intervalMs) {
+                return (float) juce::jmin (1.0, intervalMs / FrameIntervals::budget30fps) * graph.getHeight();
+            };
+
+            if (isMeterRunning())
+            {
+                auto& intervals = meter->getIntervals();
+                for (size_t i = 0; i < intervals.size(); ++i)
+                {
+                    auto x = toX (intervals.getEndMs (i));
+                    if (x < graph.getX())
+                        break;
+
+                    auto interval = intervals.getInterval (i);
+                    auto height = toHeight (interval);
+                    g.setColour (interval > FrameIntervals::budget30fps ? colors::propertyValueError : (interval > FrameIntervals::budget60fps ? colors::propertyValueWarn : colors::text));
+                    g.fillRect (x, graph.getBottom() - height, 1.0f, height);
+                }
+
+                g.setColour (colors::propertyValueWarn.withAlpha (0.5f));
+                g.drawHorizontalLine ((int) (graph.getBottom() - toHeight (FrameIntervals::budget60fps)), graph.getX(), graph.getRight());
+            }
+
+            auto& counters = Counters::getInstance();
+            for (size_t i = 0; i < counters.getNumSeries(); ++i)
+                drawSeries (g, graph, counters.getSeries (i), getSeriesColour (i), toX);
+
+            g.setFont (InspectorLookAndFeel::getInspectorFont (11, juce::Font::FontStyleFlags::plain));
+            for (size_t i = 0; i < counters.getNumMarks(); ++i)
+            {
+                auto& mark = counters.getMark (i);
+                auto x = toX (mark.ms);
+                if (x < graph.getX())
+                    break;
+
+                g.setColour (colors::highlight);
+                g.drawVerticalLine ((int) x, graph.getY(), graph.getBottom());
+                g.drawText (mark.name, juce::Rectangle<float> (x + 3, graph.getY() + 2, 120, 12), juce::Justification::centredLeft, true);
+            }
+        }
+
+        // a step line, as counters hold their value until the next sample
+        template <typename ToX>
+        static void drawSeries (juce::Graphics& g, juce::Rectangle<float> graph, const Counters::Series& series, juce::Colour colour, ToX toX)
+        {
+            if (series.size() == 0)
+                return;
+
+            auto min = series.get (0).value;
+            auto max = min;
+            for (size_t i = 0; i < series.size(); ++i)
+            {
+                min = juce::jmin (min, series.get (i).value);
+                max = juce::jmax (max, series.get (i).value);
+            }
+
+            auto toY = [&] (double value) {
+                auto normalized = max > min ? (value - min) / (max - min) : 0.5;
+                return graph.getBottom() - 2.0f - (float) normalized * (graph.getHeight() - 4.0f);
+            };
+
+            juce::Path path;
+            auto x = graph.getRight();
+            path.startNewSubPath (x, toY (series.get (0).value));
+            for (size_t i = 0; i < series.size() && x >= graph.getX(); ++i)
+            {
+                auto& sample = series.get (i);
+                x = juce::jmax (graph.getX(), toX (sample.ms));
+                path.lineTo (x, toY (sample.value));
+                if (i + 1 < series.size())
+                    path.lineTo (x, toY (series.get (i + 1).value));
+            }
+
+            g.setColour (colour);
+            g.strokePath (path, juce::PathStrokeType (1.5f));
+        }
+
+        // each counter's latest value, in its colour
+        static void drawLegend (juce::Graphics& g, juce::Rectangle<int> bounds)
+        {
+            auto& counters = Counters::getInstance();
+            g.setFont (InspectorLookAndFeel::getInspectorFont (13, juce::Font::FontStyleFlags::plain));
+
+            if (counters.getNumSeries() == 0)
+            {
+                g.setColour (colors::propertyValueDisabled);
+                g.drawText ("melatonin::counter and melatonin::mark show up here", bounds, juce::Justification::centredLeft);
+                return;
+            }
+
+            for (size_t i = 0; i < counters.getNumSeries(); ++i)
+            {
+                auto& series = counters.getSeries (i);
+                auto text = juce::String (series.name) + " " + juce::String (series.get (0).value);
+                g.setColour (getSeriesColour (i));
+                g.drawText (text, bounds.removeFromLeft (juce::jmin (bounds.getWidth(), 16 + 8 * text.length())), juce::Justification::centredLeft);
+            }
+        }
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FrameTimes)
+    };
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "melatonin_inspector/melatonin/component_model.h"
+#include "melatonin_inspector/melatonin/helpers/graphics_census.h"
+#include "melatonin_inspector/melatonin/helpers/settle_timer.h"
+
+namespace melatonin
+{
+    // Counts what the selected component asks the renderer to do when painting
+    class GraphicsCalls : public juce::Component, private ComponentModel::Listener
+    {
+    public:
+        static constexpr int rowHeight = 18;
+        static constexpr int numRows = 8;
+
+        explicit GraphicsCalls (ComponentModel& m) : model (m)
+        {
+            model.addListener (*this);
+            censusTimer.onSettled = [this] { takeCensus(); };
+        }
+
+        ~GraphicsCalls() override
+        {
+            model.removeListener (*this);
+        }
+
+        [[nodiscard]] static int getHeightNeeded()
+        {
+            return (numRows + 1) * rowHeight + 12;
+        }
+
+        void paint (juce::Graphics& g) override
+        {
+            TRACE_COMPONENT();
+
+            auto area = getLocalBounds().reduced (0, 6);
+            auto header = area.removeFromTop (rowHeight);
+
+            g.setFont (InspectorLookAndFeel::getInspectorFont (12, juce::Font::FontStyleFlags::plain));
+            g.setColour (colors::propertyValueDisabled);
+            header.removeFromLeft (labelWidth);
+            g.drawText ("OWN", header.removeFromLeft (columnWidth), juce::Justification::centredLeft);
+            g.drawText ("WITH CHILDREN", header.removeFromLeft (columnWidth), juce::Justification::centredLeft);
+
+            g.setFont (InspectorLookAndFeel::getInspectorFont (15, juce::Font::FontStyleFlags::plain));
+            drawRow (g, area.removeFromTop (rowHeight), "Fill Rect", own.fillRects, withChildren.fillRects);
+            drawRow (g, area.removeFromTop (rowHeight), "Fill Path", own.fillPaths, withChildren.fillPaths);
+            drawRow (g, area.removeFromTop (rowHeight), "Path Segments", own.pathSegments, withChildren.pathSegments);
+            drawRow (g, area.removeFromTop (rowHeight), "Draw Image", own.images, withChildren.images);
+            drawRow (g, area.removeFromTop (rowHeight), "Image Pixels", own.imagePixels, withChildren.imagePixels);
+            drawRow (g, area.removeFromTop (rowHeight), "Glyphs", own.glyphs, withChildren.glyphs);
+            drawRow (g, area.removeFromTop (rowHeight), "Gradients", own.gradients, withChildren.gradients);
+            drawRow (g, area.removeFromTop (rowHeight), "Layers / Clips", own.transparencyLayers + own.clips, withChildren.transparencyLayers + withChildren.clips);
+        }
+
+    private:
+        ComponentModel& model;
+        GraphicsCensus own, withChildren;
+        SettleTimer censusTimer;
+
+        static constexpr int labelWidth = 120;
+        static constexpr int columnWidth = 110;
+
+        // rendering offscreen isn't free, so only take a census when we're showing and the selection has settled
+        void componentModelChanged (ComponentModel&, int changes) override
+        {
+            TRACE_COMPONENT();
+
+            // what's drawn doesn't depend on position
+            if (!(changes & ComponentModel::sizeChanged))
+                return;
+
+            if (model.getSelectedComponent() != nullptr && isVisible())
+            {
+                censusTimer.request();
+            }
+            else
+            {
+                censusTimer.cancel();
+                own = {};
+                withChildren = {};
+                repaint();
+            }
+        }
+
+        void takeCensus()
+        {
+            TRACE_COMPONENT();
+
+            own = {};
+            withChildren = {};
+
+            if (auto component = model.getSelectedComponent(); component != nullptr && isVisible())
+            {
+                own = GraphicsCensus::take (*component, false);
+                withChildren = GraphicsCensus::take (*component, true);
+            }
+
+            repaint();
+        }
+
+        void visibilityChanged() override
+        {
+            if (isVisible())
+                componentModelChanged (model, ComponentModel::everythingChanged);
+        }
+
+        static void drawRow (juce::Graphics& g, juce::Rectangle<int> bounds, const juce::String& label, juce::uint64 ownCount, juce::uint64 withChildrenCount)
+        {
+            g.setColour (colors::propertyName);
+            g.drawText (label, bounds.removeFromLeft (labelWidth), juce::Justification::centredLeft);
+            drawCount (g, bounds.removeFromLeft (columnWidth), ownCount);
+            drawCount (g, bounds.removeFromLeft (columnWidth), withChildrenCount);
+        }
+
+        static void drawCount (juce::Graphics& g, juce::Rectangle<int> bounds, juce::uint64 count)
+        {
+            g.setColour (count == 0 ? colors::propertyValueDisabled : colors::propertyValue);
+            g.drawText (count == 0 ? juce::String ("-") : juce::String (count), bounds, juce::Justification::centredLeft);
+        }
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (GraphicsCalls)
+    };
+}
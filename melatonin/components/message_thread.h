@@ -0,0 +1,118 @@
+#pragma once
+
+#include "melatonin_inspector/melatonin/helpers/message_thread_monitor.h"
+#include "melatonin_inspector/melatonin/lookandfeel.h"
+
+namespace melatonin
+{
+    // Graphs how long the message thread takes to get to things, and lists recent stalls
+    class MessageThread : public juce::Component, private juce::Timer
+    {
+    public:
+        static constexpr int rowHeight = 18;
+        static constexpr int graphHeight = 60;
+        static constexpr int numStallRows = 5;
+
+        [[nodiscard]] static int getHeightNeeded()
+        {
+            return rowHeight + graphHeight + 8 + (numStallRows + 1) * rowHeight + 12;
+        }
+
+        void paint (juce::Graphics& g) override
+        {
+            TRACE_COMPONENT();
+
+            auto area = getLocalBounds().reduced (0, 6);
+            auto threshold = monitor.getStallThreshold();
+
+            float maxLatency = 0;
+            for (size_t i = 0; i < monitor.getNumLatencies(); ++i)
+                maxLatency = juce::jmax (maxLatency, monitor.getLatency (i));
+
+            g.setFont (InspectorLookAndFeel::getInspectorFont (15, juce::Font::FontStyleFlags::plain));
+            auto header = area.removeFromTop (rowHeight);
+            g.setColour (colors::propertyName);
+            g.drawText ("Latency", header.removeFromLeft (labelWidth), juce::Justification::centredLeft);
+            g.setColour (colors::propertyValue);
+            auto now = monitor.getNumLatencies() > 0 ? monitor.getLatency (0) : 0.0f;
+            g.drawText (juce::String (now, 1) + "ms, max " + juce::String (maxLatency, 1) + "ms", header, juce::Justification::centredLeft);
+
+            drawGraph (g, area.removeFromTop (graphHeight), juce::jmax ((double) maxLatency, threshold * 1.5), threshold);
+            area.removeFromTop (8);
+
+            g.setColour (colors::propertyName);
+            g.drawText ("Stalls over " + juce::String (juce::roundToInt (threshold)) + "ms (" + juce::String (monitor.getTotalStalls()) + ")", area.removeFromTop (rowHeight), juce::Justification::centredLeft);
+
+            if (monitor.getNumStalls() == 0)
+            {
+                g.setColour (colors::propertyValueDisabled);
+                g.drawText ("None yet", area.removeFromTop (rowHeight), juce::Justification::centredLeft);
+                return;
+            }
+
+            auto nowMs = juce::Time::getMillisecondCounterHiRes();
+            for (size_t i = 0; i < juce::jmin (monitor.getNumStalls(), (size_t) numStallRows); ++i)
+            {
+                auto& stall = monitor.getStall (i);
+                auto row = area.removeFromTop (rowHeight);
+
+                g.setColour (colors::propertyValueWarn);
+                g.drawText (juce::String (juce::roundToInt (stall.durationMs)) + "ms", row.removeFromLeft (60), juce::Justification::centredLeft);
+                g.setColour (colors::propertyValueDisabled);
+                g.drawText (juce::String (juce::roundToInt ((nowMs - stall.startMs) / 1000.0)) + "s ago", row.removeFromLeft (60), juce::Justification::centredLeft);
+                g.setColour (stall.painting.isEmpty() ? colors::propertyValueDisabled : colors::propertyValue);
+                g.drawText (stall.painting.isEmpty() ? juce::String ("not painting") : "painting " + stall.painting, row, juce::Justification::centredLeft, true);
+            }
+        }
+
+    private:
+        MessageThreadMonitor monitor;
+
+        static constexpr int labelWidth = 120;
+
+        // the watchdog only runs while we're showing
+        void visibilityChanged() override
+        {
+            if (isVisible())
+            {
+                monitor.start();
+                startTimerHz (10);
+            }
+            else
+            {
+                monitor.stop();
+                stopTimer();
+            }
+        }
+
+        void timerCallback() override
+        {
+            repaint();
+        }
+
+        // newest probe on the right
+        void drawGraph (juce::Graphics& g, juce::Rectangle<int> bounds, double maxMs, double threshold) const
+        {
+            g.setColour (colors::black);
+            g.fillRect (bounds);
+
+            auto toHeight = [&] (double ms) {
+                return (float) juce::jmin (1.0, ms / maxMs) * (float) bounds.getHeight();
+            };
+
+            auto numBars = juce::jmin (monitor.getNumLatencies(), (size_t) (bounds.getWidth() / 2));
+            for (size_t i = 0; i < numBars; ++i)
+            {
+                auto latency = monitor.getLatency (i);
+                auto height = juce::jmax (1.0f, toHeight (latency));
+                g.setColour (latency > threshold ? colors::propertyValueError : colors::text);
+                g.fillRect ((float) bounds.getRight() - (float) (i + 1) * 2.0f, (float) bounds.getBottom() - height, 1.0f, height);
+            }
+
+            g.setColour (colors::propertyValueWarn.withAlpha (0.5f));
+            g.drawHorizontalLine (bounds.getBottom() - (int) toHeight (threshold), (float) bounds.getX(), (float) bounds.getRight());
+        }
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MessageThread)
+    };
+}
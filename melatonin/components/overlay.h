@@ -1,11 +1,13 @@
 #pragma once
 #include "../helpers/misc.h"
+#include "../helpers/overdraw.h"
+#include "../helpers/paint_flashes.h"
 #include "../lookandfeel.h"
 
 namespace melatonin
 {
 
-    class Overlay : public juce::Component, public juce::ComponentListener
+    class Overlay : public juce::Component, public juce::ComponentListener, private juce::Timer
     {
     public:
         Overlay()
@@ -49,6 +51,13 @@ namespace melatonin
         void paint (juce::Graphics& g) override
         {
             TRACE_COMPONENT();
+
+            if (overdrawHeatmap)
+                drawOverdraw (g);
+
+            if (paintFlashing)
+                drawPaintFlashes (g);
+
             g.setColour (colors::overlayBoundingBox);
 
             // draws inwards as the line thickens
@@ -295,6 +304,24 @@ namespace melatonin
             }
         }
 
+        // flash the areas of the root that repaint, needs the automatic timing shims installed
+        void setPaintFlashing (bool enable)
+        {
+            paintFlashing = enable;
+            PaintFlashes::getInstance().setEnabled (enable);
+            updateTimer();
+            repaint();
+        }
+
+        // covers the root with a heatmap of how many times each pixel is painted
+        void setOverdrawHeatmap (bool enable)
+        {
+            overdrawHeatmap = enable;
+            overdraw = {};
+            updateTimer();
+            repaint();
+        }
+
         void enableDragging (bool enableDragging)
         {
             isDraggingEnabled = enableDragging;
@@ -344,6 +371,106 @@ namespace melatonin
         juce::Label dimensions;
         juce::Rectangle<int> dimensionsLabelBounds;
 
+        bool paintFlashing = false;
+        bool overdrawHeatmap = false;
+        Overdraw overdraw;
+        int framesUntilOverdraw = 0;
+
+        void updateTimer()
+        {
+            if (paintFlashing || overdrawHeatmap)
+                startTimerHz (60);
+            else
+                stopTimer();
+        }
+
+        void timerCallback() override
+        {
+            if (overdrawHeatmap)
+                updateOverdraw();
+
+            if (paintFlashing)
+                updatePaintFlashes();
+        }
+
+        // rendering the root offscreen isn't cheap, so only do it a few times a second
+        void updateOverdraw()
+        {
+            if (--framesUntilOverdraw > 0 || !isShowing() || getParentComponent() == nullptr)
+                return;
+
+            framesUntilOverdraw = 15;
+            overdraw.update (*getParentComponent());
+            repaint();
+        }
+
+        void drawOverdraw (juce::Graphics& g)
+        {
+            if (!overdraw.heatmap.isValid())
+                return;
+
+            g.drawImageAt (overdraw.heatmap, 0, 0);
+
+            // legend
+            auto legend = getLocalBounds().removeFromBottom (24).removeFromLeft (8 * 24 + 100).translated (8, -8);
+            g.setColour (colors::black.withAlpha (0.7f));
+            g.fillRoundedRectangle (legend.toFloat(), 3);
+            legend.reduce (6, 4);
+
+            g.setColour (colors::white);
+            g.setFont (InspectorLookAndFeel::getInspectorFont (12, juce::Font::FontStyleFlags::plain));
+            g.drawText (juce::String (overdraw.getRatio(), 1) + "x overdraw", legend.removeFromLeft (90), juce::Justification::centredLeft);
+
+            for (int count = 1; count <= Overdraw::hottestCount; ++count)
+            {
+                auto swatch = legend.removeFromLeft (24);
+                g.setColour (Overdraw::getColourForCount (count).withAlpha (1.0f));
+                g.fillRect (swatch.reduced (1));
+                g.setColour (colors::black);
+                g.drawText (count == Overdraw::hottestCount ? juce::String (count) + "+" : juce::String (count), swatch, juce::Justification::centred);
+            }
+        }
+
+        // only repaint the flashing areas, a full repaint here would repaint the whole root
+        void updatePaintFlashes()
+        {
+            auto& flashes = PaintFlashes::getInstance();
+
+            if (!isShowing())
+            {
+                flashes.removeFadedOut (std::numeric_limits<double>::max());
+                return;
+            }
+
+            // includes flashes fading out this frame, so they get erased
+            flashes.forEach ([this] (const PaintFlashes::Flash& flash) {
+                repaint (getLocalArea (nullptr, flash.area));
+            });
+
+            flashes.removeFadedOut (juce::Time::getMillisecondCounterHiRes());
+        }
+
+        void drawPaintFlashes (juce::Graphics& g)
+        {
+            auto now = juce::Time::getMillisecondCounterHiRes();
+
+            PaintFlashes::getInstance().forEach ([&] (const PaintFlashes::Flash& flash) {
+                auto opacity = PaintFlashes::getOpacity (flash, now);
+                if (opacity <= 0.0f)
+                    return;
+
+                // green for a one-off repaint, heading to red as it keeps repainting
+                auto hue = juce::jmap ((float) juce::jmin (flash.hits, 16), 1.0f, 16.0f, 0.33f, 0.0f);
+                auto colour = juce::Colour::fromHSV (hue, 0.9f, 1.0f, 1.0f);
+                auto area = getLocalArea (nullptr, flash.area);
+
+                g.setColour (colour.withAlpha (0.3f * opacity));
+                g.fillRect (area);
+                g.setColour (colour.withAlpha (0.8f * opacity));
+                g.drawRect (area);
+            });
+        }
+
         juce::Rectangle<int> getLocalAreaForOutline (Component* component, int borderSize = 2)
         {
             auto boundsPlusOutline = component->getBounds().expanded (borderSize);
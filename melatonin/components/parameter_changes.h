@@ -0,0 +1,105 @@
+#pragma once
+
+#include "melatonin_inspector/melatonin/components/fps_meter.h"
+#include "melatonin_inspector/melatonin/helpers/parameter_monitor.h"
+#include "melatonin_inspector/melatonin/lookandfeel.h"
+
+#if JUCE_MODULE_AVAILABLE_juce_audio_processors
+
+namespace melatonin
+{
+    // Parameter change notifications per second next to the FPS, to spot parameter storms
+    class ParameterChanges : public juce::Component, private juce::Timer
+    {
+    public:
+        static constexpr int rowHeight = 18;
+        static constexpr int numRows = 3 + (int) ParameterMonitor::maxOffenders;
+
+        // faster than the screen refreshes, so some of that work is wasted
+        static constexpr float floodRate = 60.0f;
+
+        [[nodiscard]] static int getHeightNeeded()
+        {
+            return numRows * rowHeight + 12;
+        }
+
+        void setFPSMeter (FPSMeter* m)
+        {
+            meter = m;
+        }
+
+        // only editors have a processor, for everything else the panel is hidden
+        void setProcessor (juce::AudioProcessor* p)
+        {
+            processor = p;
+            monitor.stop();
+            visibilityChanged();
+        }
+
+        [[nodiscard]] bool hasProcessor() const noexcept { return processor != nullptr; }
+
+        void paint (juce::Graphics& g) override
+        {
+            TRACE_COMPONENT();
+
+            auto area = getLocalBounds().reduced (0, 6);
+            g.setFont (InspectorLookAndFeel::getInspectorFont (15, juce::Font::FontStyleFlags::plain));
+
+            auto fps = meter != nullptr && meter->isVisible() ? juce::String (meter->getStats().fps, 1) : juce::String ("FPS meter is off");
+            InspectorLookAndFeel::drawStatRow (g, area.removeFromTop (rowHeight), "FPS", fps, false);
+            InspectorLookAndFeel::drawStatRow (g, area.removeFromTop (rowHeight), "Changes/s", juce::String (juce::roundToInt (monitor.getTotalRate())), monitor.getTotalRate() > floodRate);
+            InspectorLookAndFeel::drawStatRow (g, area.removeFromTop (rowHeight), "Peak", juce::String (juce::roundToInt (monitor.getPeakRate())), monitor.getPeakRate() > floodRate);
+
+            if (monitor.getNumOffenders() == 0)
+            {
+                g.setColour (colors::propertyValueDisabled);
+                g.drawText ("No parameters are changing", area.removeFromTop (rowHeight), juce::Justification::centredLeft);
+                return;
+            }
+
+            auto maxRate = monitor.getOffender (0).rate;
+            for (size_t i = 0; i < monitor.getNumOffenders(); ++i)
+            {
+                auto& offender = monitor.getOffender (i);
+                auto row = area.removeFromTop (rowHeight);
+                auto bar = row.removeFromLeft (InspectorLookAndFeel::statLabelWidth).reduced (0, 5).toFloat();
+
+                g.setColour (offender.rate > floodRate ? colors::propertyValueWarn : colors::propertyValueDisabled);
+                g.fillRect (bar.withWidth (juce::jmax (1.0f, (bar.getWidth() - 8.0f) * offender.rate / maxRate)));
+                g.setColour (colors::propertyValue);
+                g.drawText (juce::String (juce::roundToInt (offender.rate)) + "/s " + offender.parameter->getName (64), row, juce::Justification::centredLeft, true);
+            }
+        }
+
+    private:
+        FPSMeter* meter = nullptr;
+        juce::AudioProcessor* processor = nullptr;
+        ParameterMonitor monitor;
+
+        // opt in: we only listen to parameters while the panel is open
+        void visibilityChanged() override
+        {
+            if (isVisible() && processor != nullptr)
+            {
+                if (!monitor.isRunning())
+                    monitor.start (*processor);
+                startTimer (1000);
+            }
+            else
+            {
+                monitor.stop();
+                stopTimer();
+            }
+        }
+
+        void timerCallback() override
+        {
+            monitor.drain();
+            repaint();
+        }
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ParameterChanges)
+    };
+}
+
+#endif
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "melatonin_inspector/melatonin/helpers/colors.h"
+#include "melatonin_inspector/melatonin/lookandfeel.h"
+
+namespace melatonin
+{
+    // small text toggle, styled like the RGBA/HEX toggle
+    class PillToggle : public juce::Component
+    {
+    public:
+        bool on = false;
+        std::function<void()> onClick;
+
+        explicit PillToggle (const juce::String& t) : text (t) {}
+
+        void paint (juce::Graphics& g) override
+        {
+            g.setColour (on ? colors::highlight : colors::customBackground);
+            g.fillRoundedRectangle (getLocalBounds().withSizeKeepingCentre (getWidth() - 4, 16).toFloat(), 3);
+            g.setColour (on ? colors::highlightedText : colors::label);
+            g.setFont (InspectorLookAndFeel::getInspectorFont (9, juce::Font::FontStyleFlags::bold));
+            g.drawText (text, getLocalBounds(), juce::Justification::centred);
+        }
+
+        void mouseDown (const juce::MouseEvent& /*event*/) override
+        {
+            on = !on;
+            if (onClick)
+                onClick();
+            repaint();
+        }
+
+    private:
+        juce::String text;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PillToggle)
+    };
+}
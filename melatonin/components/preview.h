@@ -1,6 +1,10 @@
 #pragma once
 
 #include "melatonin_inspector/melatonin/component_model.h"
+#include "melatonin_inspector/melatonin/components/pill_toggle.h"
+#include "melatonin_inspector/melatonin/helpers/magnifier.h"
+#include "melatonin_inspector/melatonin/helpers/preview_cache.h"
+#include "melatonin_inspector/melatonin/helpers/settle_timer.h"
 
 namespace melatonin
 {
@@ -15,8 +19,13 @@ namespace melatonin
         {
             setInterceptsMouseClicks (true, true);
             model.addListener (*this);
+            snapshotTimer.onSettled = [this] {
+                takeSnapshot();
+                repaint();
+            };
             addChildComponent (maxLabel);
             addAndMakeVisible (timingToggle);
+            addAndMakeVisible (fullResolutionToggle);
             maxLabel.setColour (juce::Label::textColourId, colors::iconOff);
             maxLabel.setJustificationType (juce::Justification::centredTop);
             maxLabel.setFont (InspectorLookAndFeel::getInspectorFont (18, juce::Font::FontStyleFlags::bold));
@@ -34,6 +43,13 @@ namespace melatonin
                 settings->props->setValue ("showPerformanceTimings", timingToggle.on);
                 getParentComponent()->resized();
             };
+
+            // for zooming in on details with the color picker's loupe or a screenshot
+            fullResolutionToggle.on = settings->props->getBoolValue ("previewFullResolution", false);
+            fullResolutionToggle.onClick = [this] {
+                settings->props->setValue ("previewFullResolution", fullResolutionToggle.on);
+                requestSnapshot();
+            };
         }
 
         ~Preview() override
@@ -55,26 +71,27 @@ namespace melatonin
                 g.setColour (colors::propertyValueError.withAlpha (0.17f));
                 g.fillRoundedRectangle (maxBounds.toFloat(), 3);
 
+                // column headers, with the number of recorded paints above the row labels
+                g.setFont (g.getCurrentFont().withHeight (12.0f));
+                g.setColour (colors::propertyValueDisabled);
+                auto header = headerBounds;
+                g.drawText (juce::String (model.timing.count) + (model.timing.count == 1 ? " paint" : " paints"), header.removeFromLeft (100), juce::Justification::topLeft);
+                for (auto* caption : { "p50", "p90", "p99" })
+                    g.drawText (caption, header.removeFromLeft (60), juce::Justification::topLeft);
+
                 g.setFont (g.getCurrentFont().withHeight (15.0f));
-                double exclusiveSum = (double) model.timing1.getValue() + (double) model.timing2.getValue() + (double) model.timing3.getValue();
-                bool hasExclusive = exclusiveSum * 1000 * 1000 > 1; // at least 1 microsecond
+                bool hasExclusive = model.timing.max * 1000 * 1000 > 1; // at least 1 microsecond
                 bool hasChildren = model.hasChildren.getValue();
 
                 auto exclusive = exclusiveBounds;
                 g.setColour (hasExclusive ? colors::propertyName : colors::propertyValueDisabled);
                 g.drawText ("Exclusive", exclusive.removeFromLeft (100), juce::Justification::topLeft);
-                drawTimingText (g, exclusive.removeFromLeft (60), model.timing1.getValue(), !hasExclusive);
-                drawTimingText (g, exclusive.removeFromLeft (60), model.timing2.getValue(), !hasExclusive);
-                drawTimingText (g, exclusive.removeFromLeft (60), model.timing3.getValue(), !hasExclusive);
-                drawTimingText (g, exclusive.removeFromLeft (60), model.timingMax.getValue(), !hasExclusive);
+                drawTimingRow (g, exclusive, model.timing, !hasExclusive);
 
                 auto withChildren = withChildrenBounds;
                 g.setColour (hasChildren ? colors::propertyName : colors::propertyValueDisabled);
                 g.drawText ("With Children", withChildren.removeFromLeft (100), juce::Justification::topLeft);
-                drawTimingText (g, withChildren.removeFromLeft (60), model.timingWithChildren1, !hasChildren);
-                drawTimingText (g, withChildren.removeFromLeft (60), model.timingWithChildren2, !hasChildren);
-                drawTimingText (g, withChildren.removeFromLeft (60), model.timingWithChildren3, !hasChildren);
-                drawTimingText (g, withChildren.removeFromLeft (60), model.timingWithChildrenMax, !hasChildren);
+                drawTimingRow (g, withChildren, model.timingWithChildren, !hasChildren);
             }
             else
             {
@@ -84,9 +101,6 @@ namespace melatonin
             if (colorPicking)
             {
                 // lets see them pixels!
-                g.saveState();
-                g.setImageResamplingQuality (juce::Graphics::ResamplingQuality::lowResamplingQuality);
-
                 /* the zoomed snapshot is always *larger* than our preview area
 
                   bleed
@@ -100,17 +114,18 @@ namespace melatonin
                  */
                 int imageY = contentBounds.getY();
                 int bleedPerSide = (previewImage.getWidth() * zoomScale - getWidth()) / 2;
-                g.drawImageTransformed (previewImage, juce::AffineTransform::scale ((float) zoomScale, (float) zoomScale).translated ((float) -bleedPerSide, (float) imageY));
 
-                // draw grid
-                g.setColour (juce::Colours::grey.withAlpha (0.3f));
-                for (auto i = 0; i < contentBounds.getHeight() / zoomScale; i++)
-                    g.drawHorizontalLine (imageY + i * zoomScale, 0, (float) getWidth());
+                // upscaled with the grid in one pass, then blitted
+                if (previewImage.isValid() && !contentBounds.isEmpty())
+                {
+                    if (zoomedImage.getWidth() != getWidth() || zoomedImage.getHeight() != contentBounds.getHeight())
+                        zoomedImage = juce::Image (juce::Image::ARGB, getWidth(), contentBounds.getHeight(), false);
+                    Magnifier::render (previewImage, zoomedImage, zoomScale, juce::jmax (0, bleedPerSide), juce::Colours::grey.withAlpha (0.3f));
+                    g.drawImageAt (zoomedImage, juce::jmax (0, -bleedPerSide), imageY);
+                }
 
                 int numberOfVerticalLines = previewImage.getWidth() - 1;
                 auto inset = zoomScale - bleedPerSide;
-                for (auto i = 0; i < numberOfVerticalLines; i++)
-                    g.drawVerticalLine (inset + i * zoomScale, (float) imageY, (float) contentBounds.getBottom());
 
                 // highlight the center pixel in first black, then white boxes
                 g.setColour (juce::Colours::black);
@@ -121,7 +136,18 @@ namespace melatonin
                 g.drawRect (highlightedPixelX, highlightY - 10, zoomScale, zoomScale);
                 g.setColour (juce::Colours::white);
                 g.drawRect (highlightedPixelX - 2, highlightY - 12, 24, 24, 2);
-                g.restoreState(); // back to full quality drawing
+            }
+            else if (snapshotTimer.isPending())
+            {
+                // a cheap stand-in with the right proportions until the snapshot is taken
+                if (!placeholderSize.isEmpty())
+                {
+                    auto bounds = juce::RectanglePlacement (juce::RectanglePlacement::centred).appliedTo (placeholderSize.toFloat(), maxPreviewImageBounds.toFloat()).getSmallestIntegerContainer();
+                    auto checkersClipBounds = bounds.translated (-maxPreviewImageBounds.getX(), -maxPreviewImageBounds.getY());
+                    g.drawImageAt (checkerboard.getClippedImage (checkersClipBounds), bounds.getX(), bounds.getY());
+                    g.setColour (colors::black.withAlpha (0.4f));
+                    g.fillRect (bounds);
+                }
             }
             else if (!previewImage.isNull())
             {
@@ -163,11 +189,14 @@ namespace melatonin
             buttonsBounds = area.removeFromTop (32);
             timingToggle.setBounds (buttonsBounds.removeFromRight (32));
             buttonsBounds.removeFromRight (12);
+            fullResolutionToggle.setBounds (buttonsBounds.removeFromRight (64));
             contentBounds = area;
+            laidOutWithTimings = showsPerformanceTimings();
 
-            if (showsPerformanceTimings())
+            if (laidOutWithTimings)
             {
-                auto performanceBounds = area.removeFromBottom (50).withLeft (32);
+                auto performanceBounds = area.removeFromBottom (66).withLeft (32);
+                headerBounds = performanceBounds.removeFromTop (16);
                 maxBounds = performanceBounds.withLeft (304).withWidth (80).translated (0, -4).withTrimmedBottom (4);
                 auto pivot = maxBounds.getTopRight().toFloat();
                 exclusiveBounds = performanceBounds.removeFromTop (25);
@@ -177,6 +206,7 @@ namespace melatonin
             }
             else
             {
+                headerBounds = juce::Rectangle<int>();
                 exclusiveBounds = juce::Rectangle<int>();
                 withChildrenBounds = juce::Rectangle<int>();
             }
@@ -190,14 +220,10 @@ namespace melatonin
         {
             if (model.getSelectedComponent())
             {
-                // clear timings
-                // TODO: these should be settable from model
-                auto props = model.getSelectedComponent()->getProperties();
+                // clear timings for the component and its children
                 if (model.hasPerformanceTiming())
                 {
-                    juce::StringArray items = { "timing1", "timing2", "timing3", "timingMax", "timingWithChildren1", "timingWithChildren2", "timingWithChildren3", "timingWithChildrenMax" };
-                    for (auto& item : items)
-                        props.set (item, 0.0);
+                    resetTimings (model.getSelectedComponent());
                     model.refresh();
                 }
 
@@ -220,7 +246,8 @@ namespace melatonin
         void switchToPreview()
         {
             colorPicking = false;
-            componentModelChanged (model);
+            zoomedImage = juce::Image();
+            componentModelChanged (model, ComponentModel::everythingChanged);
             repaint();
         }
 
@@ -232,29 +259,142 @@ namespace melatonin
     private:
         juce::Image previewImage;
         juce::Image checkerboard;
+        juce::Image zoomedImage;
+
+        // snapshots are taken once hovering settles
+        SettleTimer snapshotTimer;
+        juce::Rectangle<int> placeholderSize;
+        PreviewCache cache;
         juce::SharedResourcePointer<InspectorSettings> settings;
         ComponentModel& model;
         bool colorPicking = false;
+        bool laidOutWithTimings = false;
 
         juce::Rectangle<int> buttonsBounds;
         juce::Rectangle<int> contentBounds;
+        juce::Rectangle<int> headerBounds;
         juce::Rectangle<int> exclusiveBounds;
         juce::Rectangle<int> withChildrenBounds;
         juce::Rectangle<int> maxBounds;
 
         InspectorImageButton timingToggle { "timing", { 4, 4 }, true };
+        PillToggle fullResolutionToggle { "FULL RES" };
         juce::Label maxLabel { "max", "MAX" };
 
-        void componentModelChanged (ComponentModel&) override
+        void componentModelChanged (ComponentModel&, int changes) override
+        {
+            TRACE_COMPONENT();
+
+            // the timing rows come and go with the timings
+            if (changes & ComponentModel::timingsChanged)
+            {
+                if (showsPerformanceTimings() != laidOutWithTimings && isVisible() && getParentComponent() != nullptr)
+                {
+                    laidOutWithTimings = showsPerformanceTimings();
+                    getParentComponent()->resized();
+                }
+                else
+                {
+                    repaint();
+                }
+            }
+
+            // moving doesn't change what the component looks like
+            if (!(changes & ComponentModel::sizeChanged))
+                return;
+
+            colorPicking = false;
+            requestSnapshot();
+        }
+
+        // sweeping over a big UI selects dozens of components a second
+        // so only the one the mouse stops on (or passes every maxWaitMs) is rendered
+        void requestSnapshot()
+        {
+            auto component = model.getSelectedComponent();
+            if (component == nullptr)
+            {
+                snapshotTimer.cancel();
+                previewImage = juce::Image();
+                return;
+            }
+
+            // components we've recently seen (and that haven't repainted since) show up right away
+            if (!colorPicking)
+            {
+                if (auto cached = cache.find (*component, getSnapshotScale (*component)); cached.isValid())
+                {
+                    snapshotTimer.cancel();
+                    previewImage = cached;
+                    repaint();
+                    return;
+                }
+            }
+
+            placeholderSize = component->getLocalBounds();
+            snapshotTimer.request();
+            repaint();
+        }
+
+        void takeSnapshot()
         {
             TRACE_COMPONENT();
 
+            // the color picker took over in the meantime
+            if (colorPicking)
+                return;
+
+            // our snapshot shouldn't show up in the component's timings
+            ScopedTimingPause pause;
+
             if (auto component = model.getSelectedComponent())
-                previewImage = component->createComponentSnapshot ({ component->getWidth(), component->getHeight() }, false, 2.0f);
+            {
+                auto scale = getSnapshotScale (*component);
+                previewImage = cache.find (*component, scale);
+                if (!previewImage.isValid())
+                {
+                    previewImage = component->createComponentSnapshot (component->getLocalBounds(), false, scale);
+                    cache.add (*component, scale, previewImage);
+                }
+            }
             else
+            {
                 previewImage = juce::Image();
+            }
+        }
 
-            colorPicking = false;
+        // a snapshot only needs as many pixels as the preview area shows on this display
+        // otherwise a big editor would be rendered at 2x of its full size just to be shown as a thumbnail
+        [[nodiscard]] float getSnapshotScale (const juce::Component& component) const
+        {
+            if (fullResolutionToggle.on || component.getWidth() <= 0 || component.getHeight() <= 0)
+                return 2.0f;
+
+            auto fit = juce::jmin ((float) maxPreviewImageBounds.getWidth() / (float) component.getWidth(),
+                (float) maxPreviewImageBounds.getHeight() / (float) component.getHeight());
+
+            // small components are scaled up, but we still render them as they'd look on a 2x display
+            return juce::jlimit (0.01f, 2.0f, fit * juce::Component::getApproximateScaleFactorForComponent (this));
+        }
+
+        static void drawTimingRow (juce::Graphics& g, juce::Rectangle<int> bounds, const TimingHistogram::Summary& summary, bool disabled)
+        {
+            drawTimingText (g, bounds.removeFromLeft (60), summary.p50, disabled);
+            drawTimingText (g, bounds.removeFromLeft (60), summary.p90, disabled);
+            drawTimingText (g, bounds.removeFromLeft (60), summary.p99, disabled);
+            drawTimingText (g, bounds.removeFromLeft (60), summary.max, disabled);
+        }
+
+        static void resetTimings (juce::Component* component)
+        {
+            if (auto* entry = TimingTable::getInstance().find (component))
+            {
+                entry->exclusive.reset();
+                entry->inclusive.reset();
+            }
+
+            for (auto* child : component->getChildren())
+                resetTimings (child);
         }
 
         static void drawTimingText (juce::Graphics& g, juce::Rectangle<int> bounds, double value, bool disabled = false)
@@ -294,20 +434,23 @@ namespace melatonin
             if (maxPreviewImageBounds.isEmpty())
                 return;
 
-            checkerboard = { juce::Image::RGB, maxPreviewImageBounds.getWidth(), maxPreviewImageBounds.getHeight(), true };
-            juce::Graphics g2 (checkerboard);
-            int checkerSize = settings->props->getIntValue ("checkerSize", 4);
+            checkerboard = { juce::Image::RGB, maxPreviewImageBounds.getWidth(), maxPreviewImageBounds.getHeight(), false };
+            int checkerSize = juce::jmax (1, settings->props->getIntValue ("checkerSize", 4));
 
-            for (int i = 0; i < maxPreviewImageBounds.getWidth(); i += checkerSize)
+            // one light/dark pair of checkers, tiled across the whole thing in a single fill
+            // starting at 0,0 keeps the background consistent across image positions / sizes
+            juce::Image tile (juce::Image::RGB, checkerSize * 2, checkerSize * 2, false);
             {
-                // keeps checkerboard background consistent across image positions / sizes
-                // allows for initial or ending partial checker
-                for (auto j = 0; j < maxPreviewImageBounds.getHeight(); j += checkerSize)
-                {
-                    g2.setColour (((i + j) / checkerSize) % 2 == 0 ? colors::checkerLight : colors::checkerDark);
-                    g2.fillRect (i, j, checkerSize, checkerSize);
-                }
+                juce::Graphics tileGraphics (tile);
+                tileGraphics.fillAll (colors::checkerLight);
+                tileGraphics.setColour (colors::checkerDark);
+                tileGraphics.fillRect (checkerSize, 0, checkerSize, checkerSize);
+                tileGraphics.fillRect (0, checkerSize, checkerSize, checkerSize);
             }
+
+            juce::Graphics g2 (checkerboard);
+            g2.setTiledImageFill (tile, 0, 0, 1.0f);
+            g2.fillAll();
         }
 
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Preview)
@@ -0,0 +1,222 @@
+#pragma once
+
+#include "melatonin_inspector/melatonin/helpers/counters.h"
+#include "melatonin_inspector/melatonin/helpers/process_block_times.h"
+#include "melatonin_inspector/melatonin/lookandfeel.h"
+
+namespace melatonin
+{
+    // processBlock duration vs. the buffer's deadline for the editor's processor
+    // marks are drawn on the timeline, so UI events can be lined up with load spikes
+    class ProcessorLoad : public juce::Component, private juce::Timer
+    {
+    public:
+        static constexpr int rowHeight = 18;
+        static constexpr int numRows = 5;
+        static constexpr int graphHeight = 60;
+        static constexpr double timelineMs = 10000;
+
+        [[nodiscard]] static int getHeightNeeded()
+        {
+            return numRows * rowHeight + 8 + graphHeight + 8 + graphHeight + rowHeight + 12;
+        }
+
+        ~ProcessorLoad() override
+        {
+            setRecording (false);
+            ProcessBlockTimes::getInstance().clear (processor);
+        }
+
+        // only editors have a processor, for everything else the panel is hidden
+        void setProcessor (juce::AudioProcessor* p)
+        {
+            if (p != processor)
+                ProcessBlockTimes::getInstance().clear (processor);
+
+            processor = p;
+            visibilityChanged();
+        }
+
+        [[nodiscard]] bool hasProcessor() const noexcept { return processor != nullptr; }
+
+        void paint (juce::Graphics& g) override
+        {
+            TRACE_COMPONENT();
+
+            auto area = getLocalBounds().reduced (0, 6);
+            g.setFont (InspectorLookAndFeel::getInspectorFont (15, juce::Font::FontStyleFlags::plain));
+
+            if (processor == nullptr)
+                return;
+
+            auto* times = ProcessBlockTimes::getInstance().find (processor);
+            auto numBlocks = times != nullptr ? times->getNumBlocks() : 0;
+            auto over = [&] (juce::uint64 count) { return juce::String (count) + " of " + juce::String (numBlocks); };
+
+            InspectorLookAndFeel::drawStatRow (g, area.removeFromTop (rowHeight), "Processor", processor->getName(), false);
+            InspectorLookAndFeel::drawStatRow (g, area.removeFromTop (rowHeight), "Buffer", juce::String (processor->getBlockSize()) + " @ " + juce::String (processor->getSampleRate() / 1000.0, 1) + "kHz", false);
+
+            if (numBlocks == 0)
+            {
+                g.setColour (colors::propertyValueDisabled);
+                g.drawText ("Add a melatonin::ProcessBlockProbe to processBlock", area.removeFromTop (rowHeight), juce::Justification::centredLeft);
+                return;
+            }
+
+            InspectorLookAndFeel::drawStatRow (g, area.removeFromTop (rowHeight), "Worst", percent (times->getWorstLoad()), times->getWorstLoad() > ProcessBlockTimes::riskyLoad);
+            InspectorLookAndFeel::drawStatRow (g, area.removeFromTop (rowHeight), "Over 70%", over (times->getNumRisky()), times->getNumRisky() > 0);
+            InspectorLookAndFeel::drawStatRow (g, area.removeFromTop (rowHeight), "Over 100%", over (times->getNumOverruns()), times->getNumOverruns() > 0);
+
+            area.removeFromTop (8);
+            drawTimeline (g, area.removeFromTop (graphHeight), *times);
+            area.removeFromTop (8);
+            drawHistogram (g, area.removeFromTop (graphHeight + rowHeight), *times);
+        }
+
+        void resized() override
+        {
+            maxLoadPerColumn.resize ((size_t) juce::jmax (0, getWidth()));
+        }
+
+        // start counting afresh
+        void mouseDoubleClick (const juce::MouseEvent&) override
+        {
+            ProcessBlockTimes::getInstance().clear (processor);
+            repaint();
+        }
+
+    private:
+        juce::AudioProcessor* processor = nullptr;
+        bool recording = false;
+
+        // reused, as there can be thousands of blocks on screen
+        std::vector<float> maxLoadPerColumn;
+
+        // only record and drain while someone is looking
+        void visibilityChanged() override
+        {
+            setRecording (isVisible() && processor != nullptr);
+
+            if (recording)
+                startTimerHz (10);
+            else
+                stopTimer();
+        }
+
+        void setRecording (bool shouldRecord)
+        {
+            if (shouldRecord == recording)
+                return;
+
+            recording = shouldRecord;
+            if (recording)
+                ProcessBlockTimes::getInstance().startRecording();
+            else
+                ProcessBlockTimes::getInstance().stopRecording();
+        }
+
+        void timerCallback() override
+        {
+            if (processor == nullptr)
+                return;
+
+            ProcessBlockTimes::getInstance().drain();
+            Counters::getInstance().drain();
+            repaint();
+        }
+
+        static juce::String percent (float load)
+        {
+            return juce::String (juce::roundToInt (load * 100.0f)) + "%";
+        }
+
+        static juce::Colour colourFor (float load)
+        {
+            if (load > 1.0f)
+                return colors::propertyValueError;
+            if (load > ProcessBlockTimes::riskyLoad)
+                return colors::propertyValueWarn;
+            return colors::text;
+        }
+
+        // the last 10 seconds, newest on the right, with the heaviest block per pixel
+        // the top of the graph is 100%, the deadline
+        void drawTimeline (juce::Graphics& g, juce::Rectangle<int> bounds, const ProcessBlockTimes::History& times)
+        {
+            g.setColour (colors::black);
+            g.fillRect (bounds);
+
+            auto nowMs = juce::Time::getMillisecondCounterHiRes();
+            auto width = (size_t) juce::jmin ((int) maxLoadPerColumn.size(), bounds.getWidth());
+            std::fill (maxLoadPerColumn.begin(), maxLoadPerColumn.end(), 0.0f);
+
+            for (size_t i = 0; i < times.size(); ++i)
+            {
+                auto& block = times.get (i);
+                auto column = (size_t) ((nowMs - block.startMs) / timelineMs * (double) width);
+                if (column >= width)
+                    break;
+
+                maxLoadPerColumn[width - 1 - column] = juce::jmax (maxLoadPerColumn[width - 1 - column], block.getLoad());
+            }
+
+            auto graphHeight = (float) bounds.getHeight();
+            for (size_t x = 0; x < width; ++x)
+            {
+                auto load = maxLoadPerColumn[x];
+                auto height = juce::jmin (1.0f, load) * graphHeight;
+                g.setColour (colourFor (load));
+                g.fillRect ((float) bounds.getX() + (float) x, (float) bounds.getBottom() - height, 1.0f, height);
+            }
+
+            g.setColour (colors::propertyValueWarn.withAlpha (0.5f));
+            g.drawHorizontalLine (bounds.getBottom() - (int) (ProcessBlockTimes::riskyLoad * graphHeight), (float) bounds.getX(), (float) bounds.getRight());
+
+            // app events, to see what the ui was doing at the time
+            auto& counters = Counters::getInstance();
+            g.setFont (InspectorLookAndFeel::getInspectorFont (11, juce::Font::FontStyleFlags::plain));
+            for (size_t i = 0; i < counters.getNumMarks(); ++i)
+            {
+                auto& mark = counters.getMark (i);
+                auto x = (float) bounds.getRight() - (float) ((nowMs - mark.ms) / timelineMs) * (float) bounds.getWidth();
+                if (x < (float) bounds.getX())
+                    break;
+
+                g.setColour (colors::highlight);
+                g.drawVerticalLine ((int) x, (float) bounds.getY(), (float) bounds.getBottom());
+                g.drawText (mark.name, juce::Rectangle<float> (x + 3, (float) bounds.getY() + 2, 120, 12), juce::Justification::centredLeft, true);
+            }
+        }
+
+        // how many blocks landed in each 10% of load
+        static void drawHistogram (juce::Graphics& g, juce::Rectangle<int> bounds, const ProcessBlockTimes::History& times)
+        {
+            auto labels = bounds.removeFromBottom (rowHeight);
+
+            g.setColour (colors::black);
+            g.fillRect (bounds);
+
+            juce::uint64 maxCount = 1;
+            for (size_t i = 0; i < ProcessBlockTimes::numBins; ++i)
+                maxCount = juce::jmax (maxCount, times.getBin (i));
+
+            auto binWidth = (float) bounds.getWidth() / (float) ProcessBlockTimes::numBins;
+            for (size_t i = 0; i < ProcessBlockTimes::numBins; ++i)
+            {
+                // counts span orders of magnitude, so a log scale keeps the rare slow blocks visible
+                auto count = times.getBin (i);
+                auto height = count > 0 ? juce::jmax (1.0f, (float) (std::log1p ((double) count) / std::log1p ((double) maxCount)) * (float) bounds.getHeight()) : 0.0f;
+                g.setColour (colourFor ((float) i / 10.0f + 0.05f));
+                g.fillRect ((float) bounds.getX() + (float) i * binWidth + 1.0f, (float) bounds.getBottom() - height, binWidth - 2.0f, height);
+            }
+
+            g.setColour (colors::propertyValueDisabled);
+            g.setFont (InspectorLookAndFeel::getInspectorFont (11, juce::Font::FontStyleFlags::plain));
+            g.drawText ("0%", labels, juce::Justification::centredLeft);
+            g.drawText ("100%", labels.withTrimmedLeft (juce::roundToInt (binWidth * 10.0f) - 20).withWidth (40), juce::Justification::centred);
+            g.drawText ("150%+", labels, juce::Justification::centredRight);
+        }
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ProcessorLoad)
+    };
+}
@@ -1,5 +1,7 @@
 #pragma once
 #include "melatonin_inspector/melatonin/component_model.h"
+#include "melatonin_inspector/melatonin/helpers/overdraw.h"
+#include "melatonin_inspector/melatonin/helpers/settle_timer.h"
 
 namespace melatonin
 {
@@ -10,11 +12,7 @@ namespace melatonin
         static inline juce::StringArray propertiesToIgnore { "paddingLeft",
             "paddingRight",
             "paddingTop",
-            "paddingBottom",
-            "timing1",
-            "timing2",
-            "timing3",
-            "timingMax" };
+            "paddingBottom" };
 
         explicit Properties (ComponentModel& _model) : model (_model)
         {
@@ -22,6 +20,7 @@ namespace melatonin
 
             addAndMakeVisible (&panel);
             model.addListener (*this);
+            overdrawTimer.onSettled = [this] { updateOverdraw(); };
         }
 
         ~Properties() override
@@ -45,17 +44,65 @@ namespace melatonin
     private:
         ComponentModel& model;
         juce::PropertyPanel panel { "Properties" };
+        juce::StringArray shownRows;
 
         int padding = 3;
 
-        void componentModelChanged (ComponentModel&) override
+        // rendering the selection offscreen isn't free
+        // so the overdraw ratio is only computed while its row is showing and the selection has settled
+        Overdraw overdraw;
+        SettleTimer overdrawTimer;
+        bool overdrawStale = false;
+
+        void componentModelChanged (ComponentModel&, int changes) override
         {
-            updateProperties();
+            if (changes & ComponentModel::propertiesChanged)
+                updateProperties();
+
+            if (changes & (ComponentModel::propertiesChanged | ComponentModel::sizeChanged))
+                requestOverdraw();
+        }
+
+        void visibilityChanged() override
+        {
+            if (overdrawStale)
+                requestOverdraw();
+        }
+
+        void requestOverdraw()
+        {
+            overdrawStale = model.showOverdraw && model.getSelectedComponent() != nullptr;
+            if (!overdrawStale)
+                overdraw = {};
+
+            if (overdrawStale && isShowing())
+                overdrawTimer.request();
+            else
+                overdrawTimer.cancel();
         }
 
+        void updateOverdraw()
+        {
+            auto component = model.getSelectedComponent();
+            if (!model.showOverdraw || component == nullptr || !isShowing())
+                return;
+
+            overdrawStale = false;
+            overdraw.update (*component, false);
+            model.overdrawValue = juce::String (overdraw.getRatio(), 2) + "x";
+        }
+
+        // the model reuses its Values, so existing rows update themselves
+        // only rebuild when the rows themselves change
         void updateProperties()
         {
             TRACE_COMPONENT();
+
+            auto rows = getRows();
+            if (rows == shownRows)
+                return;
+
+            shownRows = rows;
             panel.clear();
 
             if (!model.getSelectedComponent())
@@ -71,6 +118,33 @@ namespace melatonin
             resized();
         }
 
+        [[nodiscard]] juce::StringArray getRows() const
+        {
+            juce::StringArray rows;
+            if (!model.getSelectedComponent())
+                return rows;
+
+            for (auto& nv : model.namedProperties)
+            {
+                auto value = nv.value.getValue();
+
+                // these rows show a copy of the value, so a new value needs a new row
+                if ((value.isInt64() && nv.name.getLastCharacters (2) == "At") || value.isObject())
+                    rows.add (nv.name + "=" + value.toString());
+                else
+                    rows.add (nv.name + (value.isBool() ? ":bool" : ":text"));
+            }
+
+            if (dynamic_cast<juce::Button*> (model.getSelectedComponent()))
+                rows.add ("button");
+            if (model.hasRepaintRate())
+                rows.add ("repaintRate");
+            if (model.showOverdraw)
+                rows.add ("overdraw");
+
+            return rows;
+        }
+
         [[nodiscard]] juce::Array<juce::PropertyComponent*> createPropertyComponents() const
         {
             TRACE_COMPONENT();
@@ -132,6 +206,20 @@ namespace melatonin
                 new juce::BooleanPropertyComponent (model.interceptsMouseValue, "Intercepts Mouse", ""),
                 new juce::BooleanPropertyComponent (model.childrenInterceptsMouseValue, "Children Intercepts", "") });
 
+            if (model.hasRepaintRate())
+            {
+                auto repaintRate = new juce::TextPropertyComponent (model.repaintRateValue, "Repaint Rate", 200, false, false);
+                repaintRate->setEnabled (false);
+                props.add (repaintRate);
+            }
+
+            if (model.showOverdraw)
+            {
+                auto overdraw = new juce::TextPropertyComponent (model.overdrawValue, "Overdraw", 200, false, false);
+                overdraw->setEnabled (false);
+                props.add (overdraw);
+            }
+
             return props;
         }
 
@@ -0,0 +1,372 @@
+#pragma once
+#include "paint_flashes.h"
+#include "timing.h"
+#include <juce_gui_basics/juce_gui_basics.h>
+
+namespace melatonin
+{
+    // A stand-in CachedComponentImage that doesn't cache anything
+    // JUCE hands it the paint call for its component, so we can wrap that in a timer
+    // It also sees every repaint() of its component, so we count those too
+    class TimingShim : public juce::CachedComponentImage
+    {
+    public:
+        enum class Mode
+        {
+            timing, // times paints and counts repaints
+            counting, // only keeps track of what was repainted, the root always has one of these
+            ignored, // the inspector's own components that live inside the root, their repaints are told apart from the parent's own
+        };
+
+        explicit TimingShim (juce::Component& c, Mode m = Mode::timing) : component (c), mode (m)
+        {
+            // repaints weren't seen before the shim was installed
+            if (mode != Mode::ignored)
+            {
+                dirtyArea = component.getLocalBounds();
+                if (auto* entry = TimingTable::getInstance().getOrCreate (&component))
+                    ++entry->invalidations;
+            }
+        }
+
+        void paint (juce::Graphics& g) override
+        {
+            if (mode != Mode::timing)
+            {
+                if (mode == Mode::counting || hiddenDepth() == 0)
+                    component.paintEntireComponent (g, false);
+                return;
+            }
+
+            ComponentTimer timer (&component);
+            component.paintEntireComponent (g, false);
+        }
+
+        // returning true lets the repaint continue up to the parent as usual
+        bool invalidateAll() override
+        {
+            recordRepaint (component.getLocalBounds(), true);
+            return true;
+        }
+
+        bool invalidate (const juce::Rectangle<int>& area) override
+        {
+            recordRepaint (area, false);
+            return true;
+        }
+
+        void releaseResources() override {}
+
+        static bool isShim (const juce::CachedComponentImage* image)
+        {
+            return dynamic_cast<const TimingShim*> (image) != nullptr;
+        }
+
+        [[nodiscard]] Mode getMode() const noexcept { return mode; }
+
+        // between timing and counting, an ignored component stays ignored
+        void setMode (Mode newMode)
+        {
+            jassert (mode != Mode::ignored && newMode != Mode::ignored);
+            mode = newMode;
+        }
+
+        // changes whenever the component or one of its descendants is repainted
+        // 0 means there's no shim keeping track, so we can't tell
+        static juce::uint64 getInvalidations (const juce::Component& c)
+        {
+            auto shim = dynamic_cast<const TimingShim*> (c.getCachedComponentImage());
+            if (shim == nullptr || shim->mode == Mode::ignored)
+                return 0;
+
+            auto* entry = TimingTable::getInstance().find (&c);
+            return entry != nullptr ? entry->invalidations : 0;
+        }
+
+        // the bounds of everything repainted in the component (or its descendants) since the last call
+        // nullopt means there's no shim keeping track, so we can't tell
+        static std::optional<juce::Rectangle<int>> takeDirtyArea (juce::Component& c)
+        {
+            auto shim = dynamic_cast<TimingShim*> (c.getCachedComponentImage());
+            if (shim == nullptr || shim->mode == Mode::ignored)
+                return std::nullopt;
+
+            return std::exchange (shim->dirtyArea, {});
+        }
+
+        // leaves the inspector's own components out of the inspector's offscreen renders
+        class ScopedHideInspector
+        {
+        public:
+            ScopedHideInspector() { ++hiddenDepth(); }
+            ~ScopedHideInspector() { --hiddenDepth(); }
+
+        private:
+            JUCE_DECLARE_NON_COPYABLE (ScopedHideInspector)
+        };
+
+    private:
+        juce::Component& component;
+        Mode mode;
+        juce::Rectangle<int> dirtyArea;
+
+        static int& hiddenDepth()
+        {
+            static int depth = 0;
+            return depth;
+        }
+
+        // JUCE passes a repaint up the parent chain, invalidating each ancestor along the way
+        // We only want to count it against the component that called repaint()
+        struct Propagation
+        {
+            const juce::Component* ancestor = nullptr;
+            juce::Rectangle<int> area;
+            bool fromInspector = false;
+        };
+
+        // repaints only happen on the message thread
+        static Propagation& expectedPropagation()
+        {
+            static Propagation propagation;
+            return propagation;
+        }
+
+        void recordRepaint (juce::Rectangle<int> area, bool isEntireComponent)
+        {
+            auto& expected = expectedPropagation();
+
+            // an ancestor only ever receives the (non-entire) area its descendant invalidated
+            auto isFromChild = !isEntireComponent && expected.ancestor == &component && expected.area == area;
+
+            // the inspector's own repaints don't change what the app looks like
+            auto fromInspector = isFromChild ? expected.fromInspector : mode == Mode::ignored;
+
+            if (mode != Mode::ignored && !fromInspector)
+            {
+                dirtyArea = dirtyArea.isEmpty() ? area : dirtyArea.getUnion (area);
+
+                if (auto* entry = TimingTable::getInstance().getOrCreate (&component))
+                {
+                    ++entry->invalidations;
+
+                    if (mode == Mode::timing && !isFromChild)
+                    {
+                        ++entry->repaints;
+                        entry->repaintedPixels += (juce::uint64) area.getWidth() * (juce::uint64) area.getHeight();
+                    }
+                }
+            }
+
+            if (mode == Mode::timing && !isFromChild)
+            {
+                auto& flashes = PaintFlashes::getInstance();
+                if (flashes.isEnabled() && component.isShowing())
+                    flashes.add (component.localAreaToGlobal (area));
+            }
+
+            expected = nextShimmedAncestor (area, fromInspector);
+        }
+
+        // mirror what Component::internalRepaint is about to do with the ancestors
+        // ancestors without a shim (their own cached image, or skipped by the scan) can't consume the repaint
+        // so it's expected by the nearest one that has a shim, in its coordinates
+        Propagation nextShimmedAncestor (juce::Rectangle<int> area, bool fromInspector) const
+        {
+            for (auto* child = &component; !child->isOnDesktop();)
+            {
+                auto* parent = child->getParentComponent();
+                if (parent == nullptr)
+                    break;
+
+                area = parent->getLocalArea (child, area).getIntersection (parent->getLocalBounds());
+                if (area.isEmpty() || !parent->isVisible())
+                    break;
+
+                if (isShim (parent->getCachedComponentImage()))
+                    return { parent, area, fromInspector };
+
+                child = parent;
+            }
+
+            return {};
+        }
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TimingShim)
+    };
+
+    /*
+     * The inspector's own offscreen renders of the app (overdraw, graphics census).
+     *
+     * They render at 1x into a software image, like createComponentSnapshot does.
+     * They aren't real paints, so they're left out of the timings,
+     * and the inspector's own components are left out of the picture.
+     */
+    struct OffscreenRender
+    {
+        // clears the image when it's already the right size, otherwise makes a new one
+        static void prepare (juce::Image& image, juce::Rectangle<int> bounds)
+        {
+            if (image.getBounds() == bounds.withZeroOrigin())
+                image.clear (image.getBounds());
+            else
+                image = juce::Image (juce::Image::ARGB, bounds.getWidth(), bounds.getHeight(), true, juce::SoftwareImageType());
+        }
+
+        // the renderer is constructed with the image, followed by any extra args
+        template <typename Renderer, typename PaintFunction, typename... RendererArgs>
+        static void paint (const juce::Image& image, PaintFunction&& paintFunction, RendererArgs&&... rendererArgs)
+        {
+            Renderer renderer (image, std::forward<RendererArgs> (rendererArgs)...);
+            juce::Graphics g (renderer);
+
+            ScopedTimingPause pause;
+            TimingShim::ScopedHideInspector hide;
+            paintFunction (g);
+        }
+    };
+
+    /*
+     * Times every component under the root, stock JUCE widgets included,
+     * by installing a TimingShim on each one.
+     *
+     * Components that already have a CachedComponentImage (setBufferedToImage, etc) are left alone.
+     * The root itself is painted directly by its peer, so it only gets timed if it's not a top level window.
+     * It keeps a counting shim while timings are off, so the inspector can still tell what was repainted.
+     * New components are picked up by periodically rescanning the tree,
+     * which is also when repaint counts are turned into per second rates.
+     */
+    class AutomaticTimings : private juce::Timer
+    {
+    public:
+        AutomaticTimings() = default;
+
+        ~AutomaticTimings() override
+        {
+            clearRoot();
+        }
+
+        void setRoot (juce::Component& newRoot)
+        {
+            clearRoot();
+            root = &newRoot;
+
+            if (root->getCachedComponentImage() == nullptr)
+                root->setCachedComponentImage (new TimingShim (*root, TimingShim::Mode::counting));
+
+            if (enabled)
+                install();
+        }
+
+        void clearRoot()
+        {
+            uninstall();
+
+            if (root != nullptr && TimingShim::isShim (root->getCachedComponentImage()))
+                root->setCachedComponentImage (nullptr);
+
+            root = nullptr;
+        }
+
+        void setEnabled (bool shouldBeEnabled)
+        {
+            if (enabled == shouldBeEnabled)
+                return;
+
+            enabled = shouldBeEnabled;
+
+            if (enabled)
+                install();
+            else
+                uninstall();
+        }
+
+        [[nodiscard]] bool isEnabled() const { return enabled; }
+
+        // the inspector's own components (overlay, fps meter) live in the root but shouldn't be timed
+        // they always get a shim that doesn't record, even with automatic timings off
+        // otherwise their repaints would be blamed on the root
+        void ignore (juce::Component& c)
+        {
+            ignored.push_back (&c);
+
+            if (c.getCachedComponentImage() == nullptr)
+                c.setCachedComponentImage (new TimingShim (c, TimingShim::Mode::ignored));
+        }
+
+        // called after the repaint rates in the TimingTable are updated
+        std::function<void()> onRepaintRatesUpdated;
+
+    private:
+        juce::Component::SafePointer<juce::Component> root;
+        std::vector<juce::Component*> ignored;
+        bool enabled = false;
+
+        void install()
+        {
+            if (root == nullptr)
+                return;
+
+            setRootMode (TimingShim::Mode::timing);
+            addShims (*root);
+            startTimerHz (1);
+        }
+
+        void uninstall()
+        {
+            stopTimer();
+
+            if (root == nullptr)
+                return;
+
+            setRootMode (TimingShim::Mode::counting);
+            removeShims (*root);
+        }
+
+        void setRootMode (TimingShim::Mode mode)
+        {
+            if (auto shim = dynamic_cast<TimingShim*> (root->getCachedComponentImage()))
+                shim->setMode (mode);
+        }
+
+        void timerCallback() override
+        {
+            TRACE_COMPONENT();
+
+            if (root == nullptr)
+                return;
+
+            TimingTable::getInstance().sample();
+
+            addShims (*root);
+
+            if (onRepaintRatesUpdated)
+                onRepaintRatesUpdated();
+        }
+
+        void addShims (juce::Component& c)
+        {
+            if (std::find (ignored.begin(), ignored.end(), &c) != ignored.end())
+                return;
+
+            if (c.getCachedComponentImage() == nullptr)
+                c.setCachedComponentImage (new TimingShim (c));
+
+            for (auto* child : c.getChildren())
+                addShims (*child);
+        }
+
+        // only remove our own timing shims, never a cached image the app installed
+        static void removeShims (juce::Component& c)
+        {
+            auto shim = dynamic_cast<TimingShim*> (c.getCachedComponentImage());
+            if (shim != nullptr && shim->getMode() == TimingShim::Mode::timing)
+                c.setCachedComponentImage (nullptr);
+
+            for (auto* child : c.getChildren())
+                removeShims (*child);
+        }
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AutomaticTimings)
+    };
+}
@@ -18,19 +18,29 @@ namespace melatonin
         return (status == 0) ? res.get() : name;
     }
 
+    static inline juce::String typeName (const std::type_info& info)
+    {
+        return demangle (info.name());
+    }
+
     template <class T>
     static inline juce::String type (const T& t)
     {
-        return demangle (typeid (t).name());
+        return typeName (typeid (t));
     }
 }
 #else
 namespace melatonin
 {
+    static inline juce::String typeName (const std::type_info& info)
+    {
+        return juce::String (info.name()).replace ("class ", "").replace ("struct ", "");
+    }
+
     template <class T>
     static inline juce::String type (const T& t)
     {
-        return juce::String (typeid (t).name()).replace ("class ", "").replace ("struct ", "");
+        return typeName (typeid (t));
     }
 }
 #endif
@@ -0,0 +1,168 @@
+#pragma once
+#include <juce_gui_basics/juce_gui_basics.h>
+
+namespace melatonin
+{
+    /*
+     * App events to line up with frame times, e.g. "voices" or "preset loaded".
+     *
+     * Every thread that records gets one of a fixed set of preallocated SPSC fifos,
+     * so recording is wait-free and safe on the audio thread. The inspector drains them
+     * on the message thread into a short history per counter.
+     * Names must be string literals (or otherwise outlive the inspector), like Perfetto's.
+     */
+    class Counters
+    {
+    public:
+        static constexpr int maxThreads = 32;
+        static constexpr int fifoSize = 1024;
+        static constexpr size_t maxSeries = 8;
+        static constexpr size_t historySize = 512;
+        static constexpr size_t numMarks = 64;
+
+        struct Sample
+        {
+            double ms = 0;
+            double value = 0;
+        };
+
+        struct Series
+        {
+            const char* name = nullptr;
+            std::array<Sample, historySize> samples {};
+            juce::uint64 total = 0;
+
+            [[nodiscard]] size_t size() const { return (size_t) juce::jmin (total, (juce::uint64) historySize); }
+
+            // 0 is the most recent sample
+            [[nodiscard]] const Sample& get (size_t samplesAgo) const { return samples[(size_t) ((total - 1 - samplesAgo) % historySize)]; }
+        };
+
+        struct Mark
+        {
+            double ms = 0;
+            const char* name = nullptr;
+        };
+
+        static Counters& getInstance()
+        {
+            static Counters counters;
+            return counters;
+        }
+
+        // any thread
+        void record (const char* name, double value, bool isMark)
+        {
+            thread_local ThreadFifo* fifo = claimFifo();
+            if (fifo == nullptr)
+                return;
+
+            const auto scope = fifo->abstractFifo.write (1);
+            if (scope.blockSize1 == 0)
+            {
+                dropped.fetch_add (1, std::memory_order_relaxed);
+                return;
+            }
+
+            fifo->events[(size_t) scope.startIndex1] = { name, value, juce::Time::getMillisecondCounterHiRes(), isMark };
+        }
+
+        // message thread only, from here on
+
+        void drain()
+        {
+            auto numFifos = juce::jmin (claimed.load(), maxThreads);
+            for (size_t i = 0; i < (size_t) numFifos; ++i)
+            {
+                auto& fifo = fifos[i];
+                const auto scope = fifo.abstractFifo.read (fifo.abstractFifo.getNumReady());
+                scope.forEach ([&] (int index) {
+                    auto& event = fifo.events[(size_t) index];
+                    if (event.isMark)
+                        marks[(size_t) (totalMarks++ % numMarks)] = { event.ms, event.name };
+                    else if (auto* s = getSeriesFor (event.name))
+                        s->samples[(size_t) (s->total++ % historySize)] = { event.ms, event.value };
+                });
+            }
+        }
+
+        [[nodiscard]] size_t getNumSeries() const { return numSeries; }
+        [[nodiscard]] const Series& getSeries (size_t index) const { return series[index]; }
+
+        [[nodiscard]] size_t getNumMarks() const { return (size_t) juce::jmin (totalMarks, (juce::uint64) numMarks); }
+
+        // 0 is the most recent mark
+        [[nodiscard]] const Mark& getMark (size_t marksAgo) const { return marks[(size_t) ((totalMarks - 1 - marksAgo) % numMarks)]; }
+
+        // events that didn't fit, because nobody drained in time or too many threads recorded
+        [[nodiscard]] juce::uint64 getNumDropped() const { return dropped.load(); }
+
+    private:
+        struct Event
+        {
+            const char* name = nullptr;
+            double value = 0;
+            double ms = 0;
+            bool isMark = false;
+        };
+
+        struct ThreadFifo
+        {
+            juce::AbstractFifo abstractFifo { fifoSize };
+            std::array<Event, fifoSize> events {};
+        };
+
+        // all preallocated, as the first event could come from the audio thread
+        std::array<ThreadFifo, maxThreads> fifos;
+        std::atomic<int> claimed { 0 };
+        std::atomic<juce::uint64> dropped { 0 };
+
+        std::array<Series, maxSeries> series;
+        size_t numSeries = 0;
+        std::array<Mark, numMarks> marks;
+        juce::uint64 totalMarks = 0;
+
+        Counters() = default;
+
+        // threads keep their fifo for good, so threads that come and go will eventually run out
+        ThreadFifo* claimFifo()
+        {
+            auto index = claimed.fetch_add (1);
+            if (index < maxThreads)
+                return &fifos[(size_t) index];
+
+            jassertfalse; // more than maxThreads threads are recording
+            return nullptr;
+        }
+
+        // the same literal can live at different addresses in different translation units
+        Series* getSeriesFor (const char* name)
+        {
+            for (size_t i = 0; i < numSeries; ++i)
+                if (series[i].name == name || std::strcmp (series[i].name, name) == 0)
+                    return &series[i];
+
+            if (numSeries == maxSeries)
+                return nullptr;
+
+            series[numSeries].name = name;
+            return &series[numSeries++];
+        }
+
+        JUCE_DECLARE_NON_COPYABLE (Counters)
+    };
+
+    // e.g. melatonin::counter ("voices", numVoices);
+    template <typename Number>
+    static inline void counter (const char* name, Number value)
+    {
+        static_assert (std::is_arithmetic_v<Number>, "counters are numbers");
+        Counters::getInstance().record (name, static_cast<double> (value), false);
+    }
+
+    // e.g. melatonin::mark ("preset loaded");
+    static inline void mark (const char* name)
+    {
+        Counters::getInstance().record (name, 0, true);
+    }
+}
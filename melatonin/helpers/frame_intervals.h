@@ -0,0 +1,125 @@
+#pragma once
+#include <juce_gui_basics/juce_gui_basics.h>
+
+// Number of frame intervals the FPS meter keeps, about 17 seconds at 60fps
+#ifndef MELATONIN_FPS_HISTORY_SIZE
+    #define MELATONIN_FPS_HISTORY_SIZE 1024
+#endif
+
+namespace melatonin
+{
+    /*
+     * A ring of raw frame intervals.
+     *
+     * A smoothed FPS hides the odd long frame, which is exactly what users notice,
+     * so stats are calculated from the raw intervals of the last few seconds.
+     */
+    class FrameIntervals
+    {
+    public:
+        static constexpr size_t capacity = MELATONIN_FPS_HISTORY_SIZE;
+        static constexpr double budget60fps = 1000.0 / 60.0;
+        static constexpr double budget30fps = 1000.0 / 30.0;
+
+        struct Stats
+        {
+            size_t numFrames = 0;
+            double fps = 0;
+            double p50 = 0;
+            double p95 = 0;
+            double p99 = 0;
+            size_t over60fpsBudget = 0; // frames longer than 16.7ms
+            size_t over30fpsBudget = 0; // frames longer than 33.3ms
+            double longestStall = 0;
+        };
+
+        FrameIntervals()
+        {
+            sorted.reserve (capacity);
+        }
+
+        void add (double nowMs, double intervalMs)
+        {
+            frames[(size_t) (total % capacity)] = { nowMs, intervalMs };
+            ++total;
+        }
+
+        void clear()
+        {
+            total = 0;
+        }
+
+        [[nodiscard]] size_t size() const
+        {
+            return (size_t) juce::jmin (total, (juce::uint64) capacity);
+        }
+
+        // 0 is the most recent frame
+        [[nodiscard]] double getInterval (size_t framesAgo) const
+        {
+            jassert (framesAgo < size());
+            return frames[(size_t) ((total - 1 - framesAgo) % capacity)].intervalMs;
+        }
+
+        // when the frame finished, in getMillisecondCounterHiRes time
+        [[nodiscard]] double getEndMs (size_t framesAgo) const
+        {
+            jassert (framesAgo < size());
+            return frames[(size_t) ((total - 1 - framesAgo) % capacity)].endMs;
+        }
+
+        Stats getStats (double nowMs, double windowMs)
+        {
+            Stats stats;
+            sorted.clear();
+
+            for (size_t i = 0; i < size(); ++i)
+            {
+                auto& frame = frames[(size_t) ((total - 1 - i) % capacity)];
+                if (nowMs - frame.endMs > windowMs)
+                    break;
+
+                sorted.push_back (frame.intervalMs);
+                stats.over60fpsBudget += frame.intervalMs > budget60fps ? 1 : 0;
+                stats.over30fpsBudget += frame.intervalMs > budget30fps ? 1 : 0;
+                stats.longestStall = juce::jmax (stats.longestStall, frame.intervalMs);
+            }
+
+            stats.numFrames = sorted.size();
+            if (sorted.empty())
+                return stats;
+
+            std::sort (sorted.begin(), sorted.end());
+            stats.p50 = percentile (0.5);
+            stats.p95 = percentile (0.95);
+            stats.p99 = percentile (0.99);
+
+            auto totalMs = std::accumulate (sorted.begin(), sorted.end(), 0.0);
+            stats.fps = totalMs > 0 ? 1000.0 * (double) sorted.size() / totalMs : 0;
+
+            return stats;
+        }
+
+    private:
+        struct Frame
+        {
+            double endMs = 0;
+            double intervalMs = 0;
+        };
+
+        std::array<Frame, capacity> frames {};
+        juce::uint64 total = 0;
+
+        // preallocated, so the meter doesn't allocate while painting
+        std::vector<double> sorted;
+
+        // nearest rank
+        [[nodiscard]] double percentile (double p) const
+        {
+            auto rank = (size_t) std::ceil (p * (double) sorted.size());
+            return sorted[juce::jlimit ((size_t) 0, sorted.size() - 1, rank > 0 ? rank - 1 : 0)];
+        }
+
+        JUCE_DECLARE_NON_COPYABLE (FrameIntervals)
+    };
+}
@@ -0,0 +1,161 @@
+#pragma once
+#include <juce_gui_basics/juce_gui_basics.h>
+
+// Number of paint passes the flame chart can look back through
+#ifndef MELATONIN_FLAME_CHART_FRAMES
+    #define MELATONIN_FLAME_CHART_FRAMES 120
+#endif
+
+namespace melatonin
+{
+    /*
+     * Keeps every timed paint of the last few paint passes ("frames") for the flame chart.
+     *
+     * Spans are written into one big ring and frames point into it,
+     * so nothing allocates while recording. The worst frame is copied aside so it sticks around.
+     * Only the message thread records.
+     */
+    class FrameRecorder
+    {
+    public:
+        static constexpr size_t numFrames = MELATONIN_FLAME_CHART_FRAMES;
+        static constexpr size_t spanCapacity = 16384;
+        static_assert ((spanCapacity & (spanCapacity - 1)) == 0, "spanCapacity must be a power of 2");
+
+        struct Span
+        {
+            const juce::Component* component = nullptr;
+            size_t depth = 0;
+            juce::int64 startTicks = 0;
+            juce::int64 ownEndTicks = 0; // when the component's own timer stopped
+            juce::int64 endTicks = 0; // when its last timed descendant stopped
+        };
+
+        struct Frame
+        {
+            juce::uint64 firstSpan = 0; // counts from the very first span recorded
+            size_t numSpans = 0;
+            juce::int64 startTicks = 0;
+            juce::int64 endTicks = 0;
+
+            [[nodiscard]] double getDurationMs() const
+            {
+                return ticksToMs (endTicks - startTicks);
+            }
+        };
+
+        static FrameRecorder& getInstance()
+        {
+            static FrameRecorder recorder;
+            return recorder;
+        }
+
+        static double ticksToMs (juce::int64 ticks)
+        {
+            return juce::Time::highResolutionTicksToSeconds (ticks) * 1000.0;
+        }
+
+        void setEnabled (bool shouldBeEnabled)
+        {
+            enabled = shouldBeEnabled;
+        }
+
+        [[nodiscard]] bool isEnabled() const noexcept { return enabled; }
+
+        void addSpan (const juce::Component* component, size_t depth, juce::int64 startTicks, juce::int64 ownEndTicks, juce::int64 endTicks)
+        {
+            if (!enabled)
+                return;
+
+            auto& span = spans[(size_t) (totalSpans & (spanCapacity - 1))];
+            span.component = component;
+            span.depth = depth;
+            span.startTicks = startTicks;
+            span.ownEndTicks = ownEndTicks;
+            span.endTicks = endTicks;
+            ++totalSpans;
+
+            if (current.numSpans++ == 0 || startTicks < current.startTicks)
+                current.startTicks = startTicks;
+            current.endTicks = juce::jmax (current.endTicks, endTicks);
+        }
+
+        // called once all timers of a paint pass have finished
+        void endFrame()
+        {
+            if (!enabled || current.numSpans == 0)
+                return;
+
+            frames[(size_t) (totalFrames % numFrames)] = current;
+            ++totalFrames;
+
+            if (current.getDurationMs() > worst.getDurationMs() && current.numSpans <= worstSpans.capacity())
+            {
+                worst = current;
+                worstSpans.clear();
+                for (auto i = current.firstSpan; i < current.firstSpan + current.numSpans; ++i)
+                    worstSpans.push_back (spans[(size_t) (i & (spanCapacity - 1))]);
+            }
+
+            current = {};
+            current.firstSpan = totalSpans;
+        }
+
+        [[nodiscard]] size_t getNumFrames() const
+        {
+            return (size_t) juce::jmin (totalFrames, (juce::uint64) numFrames);
+        }
+
+        // 0 is the most recent frame
+        [[nodiscard]] const Frame& getFrame (size_t framesAgo) const
+        {
+            jassert (framesAgo < getNumFrames());
+            return frames[(size_t) ((totalFrames - 1 - framesAgo) % numFrames)];
+        }
+
+        // returns false if the frame's spans have since been overwritten
+        bool copySpans (const Frame& frame, std::vector<Span>& dest) const
+        {
+            dest.clear();
+            if (totalSpans - frame.firstSpan > spanCapacity)
+                return false;
+
+            for (auto i = frame.firstSpan; i < frame.firstSpan + frame.numSpans; ++i)
+                dest.push_back (spans[(size_t) (i & (spanCapacity - 1))]);
+
+            return true;
+        }
+
+        [[nodiscard]] const Frame& getWorstFrame() const noexcept { return worst; }
+        [[nodiscard]] const std::vector<Span>& getWorstSpans() const noexcept { return worstSpans; }
+
+        void clear()
+        {
+            totalFrames = 0;
+            current = {};
+            current.firstSpan = totalSpans;
+            worst = {};
+            worstSpans.clear();
+        }
+
+    private:
+        std::vector<Span> spans = std::vector<Span> (spanCapacity);
+        juce::uint64 totalSpans = 0;
+
+        std::array<Frame, numFrames> frames {};
+        juce::uint64 totalFrames = 0;
+        Frame current;
+
+        Frame worst;
+        std::vector<Span> worstSpans;
+
+        bool enabled = false;
+
+        FrameRecorder()
+        {
+            worstSpans.reserve (4096);
+        }
+
+        JUCE_DECLARE_NON_COPYABLE (FrameRecorder)
+    };
+}
@@ -0,0 +1,162 @@
+#pragma once
+#include "automatic_timings.h"
+#include <juce_gui_basics/juce_gui_basics.h>
+
+namespace melatonin
+{
+    // What a paint actually asked the renderer to do
+    struct GraphicsCensus
+    {
+        juce::uint64 fillRects = 0;
+        juce::uint64 fillPaths = 0;
+        juce::uint64 pathSegments = 0;
+        juce::uint64 images = 0;
+        juce::uint64 imagePixels = 0;
+        juce::uint64 glyphs = 0;
+        juce::uint64 gradients = 0;
+        juce::uint64 transparencyLayers = 0;
+        juce::uint64 clips = 0;
+
+        // without children, only the component's own paint and paintOverChildren are counted
+        static GraphicsCensus take (juce::Component& component, bool includeChildren);
+    };
+
+    /*
+     * A software renderer that counts the calls it receives.
+     *
+     * Rounded rectangles, ellipses and strokes arrive as filled paths,
+     * as that's what Graphics turns them into.
+     */
+    class CountingRenderer : public juce::LowLevelGraphicsSoftwareRenderer
+    {
+    public:
+        CountingRenderer (const juce::Image& image, GraphicsCensus& c) : LowLevelGraphicsSoftwareRenderer (image), census (c) {}
+
+        bool clipToRectangle (const juce::Rectangle<int>& r) override
+        {
+            ++census.clips;
+            return LowLevelGraphicsSoftwareRenderer::clipToRectangle (r);
+        }
+
+        bool clipToRectangleList (const juce::RectangleList<int>& list) override
+        {
+            ++census.clips;
+            return LowLevelGraphicsSoftwareRenderer::clipToRectangleList (list);
+        }
+
+        void excludeClipRectangle (const juce::Rectangle<int>& r) override
+        {
+            ++census.clips;
+            LowLevelGraphicsSoftwareRenderer::excludeClipRectangle (r);
+        }
+
+        void clipToPath (const juce::Path& path, const juce::AffineTransform& t) override
+        {
+            ++census.clips;
+            LowLevelGraphicsSoftwareRenderer::clipToPath (path, t);
+        }
+
+        void clipToImageAlpha (const juce::Image& image, const juce::AffineTransform& t) override
+        {
+            ++census.clips;
+            LowLevelGraphicsSoftwareRenderer::clipToImageAlpha (image, t);
+        }
+
+        void beginTransparencyLayer (float opacity) override
+        {
+            ++census.transparencyLayers;
+            LowLevelGraphicsSoftwareRenderer::beginTransparencyLayer (opacity);
+        }
+
+        void setFill (const juce::FillType& fill) override
+        {
+            if (fill.isGradient())
+                ++census.gradients;
+            LowLevelGraphicsSoftwareRenderer::setFill (fill);
+        }
+
+        void fillRect (const juce::Rectangle<int>& r, bool replaceExistingContents) override
+        {
+            ++census.fillRects;
+            LowLevelGraphicsSoftwareRenderer::fillRect (r, replaceExistingContents);
+        }
+
+        void fillRect (const juce::Rectangle<float>& r) override
+        {
+            ++census.fillRects;
+            LowLevelGraphicsSoftwareRenderer::fillRect (r);
+        }
+
+        void fillRectList (const juce::RectangleList<float>& list) override
+        {
+            census.fillRects += (juce::uint64) list.getNumRectangles();
+            LowLevelGraphicsSoftwareRenderer::fillRectList (list);
+        }
+
+        void fillPath (const juce::Path& path, const juce::AffineTransform& t) override
+        {
+            ++census.fillPaths;
+
+            juce::Path::Iterator it (path);
+            while (it.next())
+                if (it.elementType != juce::Path::Iterator::startNewSubPath && it.elementType != juce::Path::Iterator::closePath)
+                    ++census.pathSegments;
+
+            LowLevelGraphicsSoftwareRenderer::fillPath (path, t);
+        }
+
+        void drawImage (const juce::Image& image, const juce::AffineTransform& t) override
+        {
+            ++census.images;
+            census.imagePixels += (juce::uint64) image.getWidth() * (juce::uint64) image.getHeight();
+            LowLevelGraphicsSoftwareRenderer::drawImage (image, t);
+        }
+
+#if JUCE_MAJOR_VERSION >= 8
+        void drawGlyphs (juce::Span<const juce::uint16> glyphs, juce::Span<const juce::Point<float>> positions, const juce::AffineTransform& t) override
+        {
+            census.glyphs += (juce::uint64) glyphs.size();
+            LowLevelGraphicsSoftwareRenderer::drawGlyphs (glyphs, positions, t);
+        }
+#else
+        void drawGlyph (int glyphNumber, const juce::AffineTransform& t) override
+        {
+            ++census.glyphs;
+            LowLevelGraphicsSoftwareRenderer::drawGlyph (glyphNumber, t);
+        }
+#endif
+
+    private:
+        GraphicsCensus& census;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CountingRenderer)
+    };
+
+    inline GraphicsCensus GraphicsCensus::take (juce::Component& component, bool includeChildren)
+    {
+        TRACE_EVENT ("component", "take graphics census");
+
+        GraphicsCensus census;
+        if (component.getLocalBounds().isEmpty())
+            return census;
+
+        juce::Image image;
+        OffscreenRender::prepare (image, component.getLocalBounds());
+        OffscreenRender::paint<CountingRenderer> (
+            image,
+            [&] (juce::Graphics& g) {
+                if (includeChildren)
+                {
+                    component.paintEntireComponent (g, true);
+                }
+                else
+                {
+                    component.paint (g);
+                    component.paintOverChildren (g);
+                }
+            },
+            census);
+
+        return census;
+    }
+}
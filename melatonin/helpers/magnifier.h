@@ -0,0 +1,66 @@
+#pragma once
+#include <juce_gui_basics/juce_gui_basics.h>
+
+namespace melatonin
+{
+    /*
+     * Nearest neighbour upscaling for the color picker's loupe, with the pixel grid baked in.
+     *
+     * Each source row is widened once (every pixel repeated zoom times),
+     * then copied into the rest of the rows it covers with memcpy,
+     * so the work is mostly fills and copies the compiler can vectorize.
+     * That's a lot cheaper than a transformed image draw plus a draw call per grid line.
+     */
+    struct Magnifier
+    {
+        // destination pixel x maps to source pixel (x + offsetX) / zoom
+        // source and destination must both be ARGB
+        static void render (const juce::Image& source, juce::Image& destination, int zoom, int offsetX, juce::Colour gridColour)
+        {
+            jassert (source.getFormat() == juce::Image::ARGB && destination.getFormat() == juce::Image::ARGB);
+            jassert (zoom > 0 && offsetX >= 0);
+
+            juce::Image::BitmapData src (source, juce::Image::BitmapData::readOnly);
+            juce::Image::BitmapData dst (destination, juce::Image::BitmapData::writeOnly);
+
+            auto grid = gridColour.getPixelARGB(); // premultiplied
+            auto width = dst.width;
+            auto rowBytes = (size_t) width * sizeof (juce::PixelARGB);
+
+            for (int y = 0; y < dst.height; y += zoom)
+            {
+                auto sourceY = y / zoom;
+                auto* row = reinterpret_cast<juce::PixelARGB*> (dst.getLinePointer (y));
+
+                // widen the source row, a repeat of each pixel per cell
+                // beneath the source, there's nothing but the grid
+                auto x = 0;
+                for (auto sourceX = offsetX / zoom; x < width; ++sourceX)
+                {
+                    auto pixel = juce::PixelARGB();
+                    if (sourceY < src.height && sourceX < src.width)
+                        pixel = *reinterpret_cast<const juce::PixelARGB*> (src.getPixelPointer (sourceX, sourceY));
+
+                    auto cellStart = sourceX * zoom - offsetX;
+                    auto count = juce::jmin (width, cellStart + zoom) - x;
+                    std::fill_n (row + x, count, pixel);
+
+                    // vertical grid line on the first column of the cell
+                    if (cellStart == x)
+                        row[x].blend (grid);
+
+                    x += count;
+                }
+
+                // the rest of the cell's rows are identical
+                auto lastRow = juce::jmin (dst.height, y + zoom);
+                for (auto copy = y + 1; copy < lastRow; ++copy)
+                    std::memcpy (dst.getLinePointer (copy), row, rowBytes);
+
+                // and the horizontal grid line goes on the first
+                for (x = 0; x < width; ++x)
+                    row[x].blend (grid);
+            }
+        }
+    };
+}
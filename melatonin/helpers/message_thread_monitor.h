@@ -0,0 +1,161 @@
+#pragma once
+#include "component_helpers.h"
+#include "timing.h"
+#include <juce_gui_basics/juce_gui_basics.h>
+
+namespace melatonin
+{
+    /*
+     * Tells us whether the message thread is keeping up.
+     *
+     * A watchdog thread posts timestamped probes with callAsync, one at a time.
+     * How long a probe waits in the queue is the message thread's latency.
+     * When a probe waits longer than the stall threshold, the watchdog
+     * notes which component (if any) was being timed on the message thread.
+     * If nothing was painting, something else (file io, a slow Timer, etc) blocked it.
+     */
+    class MessageThreadMonitor : private juce::Thread
+    {
+    public:
+        static constexpr size_t numLatencies = 256;
+        static constexpr size_t numStalls = 32;
+        static constexpr int probeIntervalMs = 50;
+
+        struct Stall
+        {
+            double startMs = 0;
+            double durationMs = 0;
+            juce::String painting; // empty when nothing was being painted
+        };
+
+        MessageThreadMonitor() : juce::Thread ("Melatonin Watchdog") {}
+
+        ~MessageThreadMonitor() override
+        {
+            stop();
+        }
+
+        void start()
+        {
+            startThread();
+        }
+
+        void stop()
+        {
+            stopThread (1000);
+        }
+
+        void setStallThreshold (double ms)
+        {
+            stallThresholdMs = ms;
+        }
+
+        [[nodiscard]] double getStallThreshold() const noexcept { return stallThresholdMs; }
+
+        // everything below is for the message thread
+
+        [[nodiscard]] size_t getNumLatencies() const
+        {
+            return (size_t) juce::jmin (totalLatencies, (juce::uint64) numLatencies);
+        }
+
+        // 0 is the most recent probe
+        [[nodiscard]] float getLatency (size_t probesAgo) const
+        {
+            jassert (probesAgo < getNumLatencies());
+            return latencies[(size_t) ((totalLatencies - 1 - probesAgo) % numLatencies)];
+        }
+
+        [[nodiscard]] size_t getNumStalls() const
+        {
+            return (size_t) juce::jmin (totalStalls, (juce::uint64) numStalls);
+        }
+
+        // 0 is the most recent stall
+        [[nodiscard]] const Stall& getStall (size_t stallsAgo) const
+        {
+            jassert (stallsAgo < getNumStalls());
+            return stalls[(size_t) ((totalStalls - 1 - stallsAgo) % numStalls)];
+        }
+
+        [[nodiscard]] juce::uint64 getTotalStalls() const noexcept { return totalStalls; }
+
+    private:
+        std::atomic<double> stallThresholdMs { 100 };
+
+        // shared with the watchdog
+        std::atomic<bool> probeOutstanding { false };
+        std::atomic<bool> stallSampled { false };
+        std::atomic<const juce::Component*> paintingDuringStall { nullptr };
+
+        // message thread only
+        std::array<float, numLatencies> latencies {};
+        juce::uint64 totalLatencies = 0;
+        std::array<Stall, numStalls> stalls {};
+        juce::uint64 totalStalls = 0;
+
+        JUCE_DECLARE_WEAK_REFERENCEABLE (MessageThreadMonitor)
+
+        // created up front, so the watchdog only ever copies it
+        juce::WeakReference<MessageThreadMonitor> self { this };
+
+        void run() override
+        {
+            double postedMs = 0;
+
+            while (!threadShouldExit())
+            {
+                auto now = juce::Time::getMillisecondCounterHiRes();
+
+                if (!probeOutstanding.load())
+                {
+                    if (now - postedMs >= probeIntervalMs)
+                    {
+                        postedMs = now;
+                        stallSampled = false;
+                        paintingDuringStall = nullptr;
+                        probeOutstanding = true;
+
+                        juce::MessageManager::callAsync ([monitor = self, postedMs] {
+                            if (monitor != nullptr)
+                                monitor->probeArrived (postedMs);
+                        });
+                    }
+                }
+                else if (!stallSampled.load() && now - postedMs > stallThresholdMs.load())
+                {
+                    // the message thread is stuck, what's it doing?
+                    paintingDuringStall = TimerStack::getPaintingOnMessageThread().load (std::memory_order_relaxed);
+                    stallSampled = true;
+                }
+
+                wait (5);
+            }
+        }
+
+        void probeArrived (double postedMs)
+        {
+            auto latency = juce::Time::getMillisecondCounterHiRes() - postedMs;
+            latencies[(size_t) (totalLatencies++ % numLatencies)] = (float) latency;
+
+            if (latency > stallThresholdMs.load())
+            {
+                auto& stall = stalls[(size_t) (totalStalls++ % numStalls)];
+                stall.startMs = postedMs;
+                stall.durationMs = latency;
+                stall.painting = {};
+
+                // the component may have been deleted since, so only trust the timing table
+                if (auto* painting = stallSampled.load() ? paintingDuringStall.load() : nullptr)
+                {
+                    auto* entry = TimingTable::getInstance().find (painting);
+                    stall.painting = entry != nullptr ? componentString (entry->component) : juce::String ("(deleted component)");
+                }
+            }
+
+            probeOutstanding = false;
+        }
+
+        JUCE_DECLARE_NON_COPYABLE (MessageThreadMonitor)
+    };
+}
@@ -0,0 +1,172 @@
+#pragma once
+#include "automatic_timings.h"
+#include <juce_gui_basics/juce_gui_basics.h>
+
+namespace melatonin
+{
+    /*
+     * Renders like the software renderer, except every fill is the same translucent white.
+     *
+     * Each fill over a pixel compounds its alpha, so the final alpha of a pixel
+     * tells us how many times it was painted. Gradients, images, text and
+     * component alpha all collapse into that one fill.
+     */
+    class OverdrawRenderer : public juce::LowLevelGraphicsSoftwareRenderer
+    {
+    public:
+        static constexpr int fillAlpha = 64;
+        static constexpr int maxCount = 12; // past this, the alpha barely changes
+
+        explicit OverdrawRenderer (const juce::Image& image) : LowLevelGraphicsSoftwareRenderer (image)
+        {
+            setFill ({});
+        }
+
+        using LowLevelGraphicsSoftwareRenderer::fillRect;
+
+        void setFill (const juce::FillType&) override
+        {
+            LowLevelGraphicsSoftwareRenderer::setFill (juce::Colours::white.withAlpha ((juce::uint8) fillAlpha));
+        }
+
+        // opacity would change our fill's alpha
+        void setOpacity (float) override
+        {
+            setFill ({});
+        }
+
+        // replacing would reset the count
+        void fillRect (const juce::Rectangle<int>& area, bool) override
+        {
+            LowLevelGraphicsSoftwareRenderer::fillRect (area, false);
+        }
+
+        // an image counts as one fill over its bounds, transparent pixels included
+        void drawImage (const juce::Image& image, const juce::AffineTransform& transform) override
+        {
+            juce::Path bounds;
+            bounds.addRectangle (image.getBounds());
+            fillPath (bounds, transform);
+        }
+
+        // components with alpha, effects, etc
+        void beginTransparencyLayer (float) override
+        {
+            LowLevelGraphicsSoftwareRenderer::beginTransparencyLayer (1.0f);
+        }
+
+        // maps a pixel's alpha back to the number of fills
+        static int getCount (juce::uint8 alpha)
+        {
+            static const auto counts = [] {
+                // the software renderer blends with dest = src + dest * (256 - srcAlpha) / 256
+                std::array<int, maxCount + 1> alphaAfter {};
+                for (size_t n = 1; n < alphaAfter.size(); ++n)
+                    alphaAfter[n] = fillAlpha + ((alphaAfter[n - 1] * (256 - fillAlpha)) >> 8);
+
+                // antialiased edges land in between, so pick the nearest
+                std::array<juce::uint8, 256> lookup {};
+                for (size_t a = 0; a < lookup.size(); ++a)
+                {
+                    size_t nearest = 0;
+                    for (size_t n = 1; n < alphaAfter.size(); ++n)
+                        if (std::abs (alphaAfter[n] - (int) a) < std::abs (alphaAfter[nearest] - (int) a))
+                            nearest = n;
+                    lookup[a] = (juce::uint8) nearest;
+                }
+                return lookup;
+            }();
+
+            return counts[alpha];
+        }
+
+    private:
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OverdrawRenderer)
+    };
+
+    // How many times each pixel of a component (and its children) gets painted
+    struct Overdraw
+    {
+        static constexpr int hottestCount = 8;
+
+        // blue for pixels painted once, through to red for 8x or more
+        juce::Image heatmap;
+
+        juce::uint64 paintedPixels = 0;
+        juce::uint64 fills = 0;
+
+        // average number of times each painted pixel was filled
+        [[nodiscard]] float getRatio() const
+        {
+            return paintedPixels > 0 ? (float) ((double) fills / (double) paintedPixels) : 0.0f;
+        }
+
+        // the buffers are reused while the size stays the same, the heatmap is skipped when only the ratio is needed
+        void update (juce::Component& component, bool withHeatmap = true)
+        {
+            TRACE_EVENT ("component", "render overdraw");
+
+            paintedPixels = 0;
+            fills = 0;
+
+            auto bounds = component.getLocalBounds();
+            if (bounds.isEmpty())
+            {
+                counts = {};
+                heatmap = {};
+                return;
+            }
+
+            OffscreenRender::prepare (counts, bounds);
+            OffscreenRender::paint<OverdrawRenderer> (counts, [&] (juce::Graphics& g) { component.paintEntireComponent (g, true); });
+
+            if (withHeatmap)
+                OffscreenRender::prepare (heatmap, bounds);
+            else
+                heatmap = {};
+
+            juce::Image::BitmapData source (counts, juce::Image::BitmapData::readOnly);
+            std::optional<juce::Image::BitmapData> dest;
+            if (withHeatmap)
+                dest.emplace (heatmap, juce::Image::BitmapData::writeOnly);
+            const auto& palette = getPalette();
+
+            for (int y = 0; y < bounds.getHeight(); ++y)
+            {
+                for (int x = 0; x < bounds.getWidth(); ++x)
+                {
+                    auto alpha = reinterpret_cast<const juce::PixelARGB*> (source.getPixelPointer (x, y))->getAlpha();
+                    auto count = OverdrawRenderer::getCount (alpha);
+                    if (count == 0)
+                        continue;
+
+                    ++paintedPixels;
+                    fills += (juce::uint64) count;
+                    if (dest)
+                        *reinterpret_cast<juce::PixelARGB*> (dest->getPixelPointer (x, y)) = palette[(size_t) juce::jmin (count, hottestCount)];
+                }
+            }
+        }
+
+        static juce::Colour getColourForCount (int count)
+        {
+            auto hue = juce::jmap ((float) juce::jlimit (1, hottestCount, count), 1.0f, (float) hottestCount, 0.66f, 0.0f);
+            return juce::Colour::fromHSV (hue, 0.9f, 1.0f, 0.6f);
+        }
+
+    private:
+        // what the overdraw renderer paints into
+        juce::Image counts;
+
+        static const std::array<juce::PixelARGB, hottestCount + 1>& getPalette()
+        {
+            static const auto palette = [] {
+                std::array<juce::PixelARGB, hottestCount + 1> p {};
+                for (size_t i = 1; i < p.size(); ++i)
+                    p[i] = getColourForCount ((int) i).getPixelARGB();
+                return p;
+            }();
+            return palette;
+        }
+    };
+}
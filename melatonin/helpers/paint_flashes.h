@@ -0,0 +1,101 @@
+#pragma once
+#include <juce_gui_basics/juce_gui_basics.h>
+
+namespace melatonin
+{
+    // Regions that were recently repainted, like "paint flashing" in browser dev tools
+    // The automatic timing shims add to this, the Overlay draws and expires them
+    // Areas are stored in screen coordinates, so they survive the component going away
+    // Only access this from the message thread
+    class PaintFlashes
+    {
+    public:
+        static constexpr size_t maxFlashes = 128;
+        static constexpr double fadeMs = 400;
+
+        struct Flash
+        {
+            juce::Rectangle<int> area;
+            double lastRepaintMs = 0;
+
+            // how many times this area repainted before it faded out
+            int hits = 0;
+        };
+
+        static PaintFlashes& getInstance()
+        {
+            static PaintFlashes flashes;
+            return flashes;
+        }
+
+        void setEnabled (bool shouldBeEnabled)
+        {
+            enabled = shouldBeEnabled;
+
+            if (!enabled)
+                size = 0;
+        }
+
+        [[nodiscard]] bool isEnabled() const noexcept { return enabled; }
+        [[nodiscard]] bool isEmpty() const noexcept { return size == 0; }
+
+        void add (juce::Rectangle<int> screenArea)
+        {
+            if (!enabled || screenArea.isEmpty())
+                return;
+
+            auto now = juce::Time::getMillisecondCounterHiRes();
+
+            // the same area repainting again before fading out just gets hotter
+            for (size_t i = 0; i < size; ++i)
+            {
+                if (flashes[i].area == screenArea)
+                {
+                    flashes[i].lastRepaintMs = now;
+                    ++flashes[i].hits;
+                    return;
+                }
+            }
+
+            // when full, the oldest flash makes room
+            auto& flash = size < maxFlashes ? flashes[size++] : *std::min_element (flashes.begin(), flashes.end(), [] (const Flash& a, const Flash& b) {
+                return a.lastRepaintMs < b.lastRepaintMs;
+            });
+
+            flash.area = screenArea;
+            flash.lastRepaintMs = now;
+            flash.hits = 1;
+        }
+
+        // 1 when freshly repainted, 0 when faded out
+        [[nodiscard]] static float getOpacity (const Flash& flash, double now) noexcept
+        {
+            return (float) juce::jlimit (0.0, 1.0, 1.0 - (now - flash.lastRepaintMs) / fadeMs);
+        }
+
+        template <typename Callback>
+        void forEach (Callback&& callback) const
+        {
+            for (size_t i = 0; i < size; ++i)
+                callback (flashes[i]);
+        }
+
+        void removeFadedOut (double now)
+        {
+            for (size_t i = size; i > 0; --i)
+            {
+                if (getOpacity (flashes[i - 1], now) <= 0.0f)
+                    flashes[i - 1] = flashes[--size];
+            }
+        }
+
+    private:
+        std::array<Flash, maxFlashes> flashes;
+        size_t size = 0;
+        bool enabled = false;
+
+        PaintFlashes() = default;
+
+        JUCE_DECLARE_NON_COPYABLE (PaintFlashes)
+    };
+}
@@ -0,0 +1,134 @@
+#pragma once
+#include <juce_audio_processors/juce_audio_processors.h>
+
+#if JUCE_MODULE_AVAILABLE_juce_audio_processors
+
+namespace melatonin
+{
+    /*
+     * Counts how often each of a processor's parameters notifies its listeners.
+     *
+     * Automation can fire parameter callbacks thousands of times a second,
+     * each of which can end up as work for attachments on the message thread.
+     * Notifications come from any thread (often the audio thread), so they only bump
+     * a relaxed atomic per parameter, which the message thread turns into rates.
+     */
+    class ParameterMonitor : private juce::AudioProcessorParameter::Listener
+    {
+    public:
+        static constexpr size_t maxOffenders = 5;
+
+        struct Offender
+        {
+            juce::AudioProcessorParameter* parameter = nullptr;
+            float rate = 0;
+        };
+
+        ParameterMonitor() = default;
+
+        ~ParameterMonitor() override
+        {
+            stop();
+        }
+
+        // the processor has to outlive the monitor (or stop being called)
+        void start (juce::AudioProcessor& processor)
+        {
+            stop();
+
+            parameters = processor.getParameters();
+            counts = std::make_unique<std::atomic<juce::uint32>[]> ((size_t) parameters.size());
+            rates.assign ((size_t) parameters.size(), 0.0f);
+            lastDrainMs = juce::Time::getMillisecondCounterHiRes();
+
+            for (auto* parameter : parameters)
+                parameter->addListener (this);
+        }
+
+        void stop()
+        {
+            for (auto* parameter : parameters)
+                parameter->removeListener (this);
+
+            parameters.clear();
+            offenders = {};
+            numOffenders = 0;
+            totalRate = 0;
+            peakRate = 0;
+        }
+
+        // message thread, about once a second
+        void drain()
+        {
+            auto nowMs = juce::Time::getMillisecondCounterHiRes();
+            auto elapsedSeconds = (float) ((nowMs - lastDrainMs) / 1000.0);
+            if (parameters.isEmpty() || elapsedSeconds <= 0)
+                return;
+
+            lastDrainMs = nowMs;
+            totalRate = 0;
+            numOffenders = 0;
+
+            for (size_t i = 0; i < rates.size(); ++i)
+            {
+                rates[i] = (float) counts[i].exchange (0, std::memory_order_relaxed) / elapsedSeconds;
+                totalRate += rates[i];
+
+                if (rates[i] > 0)
+                    insertOffender ({ parameters[(int) i], rates[i] });
+            }
+
+            peakRate = juce::jmax (peakRate, totalRate);
+        }
+
+        [[nodiscard]] bool isRunning() const noexcept { return !parameters.isEmpty(); }
+        [[nodiscard]] float getTotalRate() const noexcept { return totalRate; }
+        [[nodiscard]] float getPeakRate() const noexcept { return peakRate; }
+
+        // most notifications per second first
+        [[nodiscard]] size_t getNumOffenders() const noexcept { return numOffenders; }
+        [[nodiscard]] const Offender& getOffender (size_t index) const { return offenders[index]; }
+
+    private:
+        juce::Array<juce::AudioProcessorParameter*> parameters;
+        std::unique_ptr<std::atomic<juce::uint32>[]> counts;
+
+        // message thread only
+        std::vector<float> rates;
+        std::array<Offender, maxOffenders> offenders {};
+        size_t numOffenders = 0;
+        float totalRate = 0;
+        float peakRate = 0;
+        double lastDrainMs = 0;
+
+        // any thread
+        void parameterValueChanged (int parameterIndex, float) override
+        {
+            if (juce::isPositiveAndBelow (parameterIndex, parameters.size()))
+                counts[(size_t) parameterIndex].fetch_add (1, std::memory_order_relaxed);
+        }
+
+        void parameterGestureChanged (int, bool) override {}
+
+        // keeps the top few sorted as we go, there are usually only a handful changing
+        void insertOffender (Offender offender)
+        {
+            auto position = numOffenders;
+            while (position > 0 && offenders[position - 1].rate < offender.rate)
+                --position;
+
+            if (position >= offenders.size())
+                return;
+
+            for (auto i = juce::jmin (numOffenders, offenders.size() - 1); i > position; --i)
+                offenders[i] = offenders[i - 1];
+
+            offenders[position] = offender;
+            numOffenders = juce::jmin (numOffenders + 1, offenders.size());
+        }
+
+        JUCE_DECLARE_NON_COPYABLE (ParameterMonitor)
+    };
+}
+
+#endif
@@ -0,0 +1,95 @@
+#pragma once
+#include "automatic_timings.h"
+#include <juce_gui_basics/juce_gui_basics.h>
+
+// How much memory recently previewed components can take up
+#ifndef MELATONIN_PREVIEW_CACHE_MB
+    #define MELATONIN_PREVIEW_CACHE_MB 32
+#endif
+
+namespace melatonin
+{
+    /*
+     * Least recently used preview snapshots, so hovering back and forth
+     * doesn't render the same components over and over.
+     *
+     * A snapshot stays valid until the component (or any descendant) is repainted,
+     * which only the timing shims can tell us. Without automatic timings, only the root has one.
+     */
+    class PreviewCache
+    {
+    public:
+        static constexpr size_t budgetBytes = (size_t) MELATONIN_PREVIEW_CACHE_MB * 1024 * 1024;
+
+        // returns an invalid image on a miss
+        juce::Image find (juce::Component& component, float scale)
+        {
+            auto invalidations = TimingShim::getInvalidations (component);
+
+            for (auto& item : items)
+            {
+                if (item.key != &component || item.component == nullptr)
+                    continue;
+
+                if (item.size == component.getLocalBounds() && item.scale == scale && item.invalidations == invalidations && invalidations > 0)
+                {
+                    item.lastUsed = ++uses;
+                    return item.image;
+                }
+
+                remove (item);
+                break;
+            }
+
+            return {};
+        }
+
+        void add (juce::Component& component, float scale, const juce::Image& image)
+        {
+            auto invalidations = TimingShim::getInvalidations (component);
+            auto bytes = (size_t) image.getWidth() * (size_t) image.getHeight() * 4;
+            if (invalidations == 0 || !image.isValid() || bytes > budgetBytes)
+                return;
+
+            for (size_t i = items.size(); i-- > 0;)
+                if (items[i].component == nullptr)
+                    remove (items[i]);
+
+            items.push_back ({ &component, &component, component.getLocalBounds(), scale, invalidations, image, bytes, ++uses });
+            totalBytes += bytes;
+
+            while (totalBytes > budgetBytes)
+                remove (*std::min_element (items.begin(), items.end(), [] (auto& a, auto& b) { return a.lastUsed < b.lastUsed; }));
+        }
+
+        void clear()
+        {
+            items.clear();
+            totalBytes = 0;
+        }
+
+    private:
+        struct Item
+        {
+            const juce::Component* key = nullptr;
+            juce::Component::SafePointer<juce::Component> component;
+            juce::Rectangle<int> size;
+            float scale = 1.0f;
+            juce::uint64 invalidations = 0;
+            juce::Image image;
+            size_t bytes = 0;
+            juce::uint64 lastUsed = 0;
+        };
+
+        std::vector<Item> items;
+        size_t totalBytes = 0;
+        juce::uint64 uses = 0;
+
+        void remove (Item& item)
+        {
+            totalBytes -= item.bytes;
+            std::swap (item, items.back());
+            items.pop_back();
+        }
+    };
+}
@@ -0,0 +1,245 @@
+#pragma once
+#include <juce_audio_processors/juce_audio_processors.h>
+
+namespace melatonin
+{
+    /*
+     * How long processBlock takes compared to the time the host gave it.
+     *
+     * Every audio thread gets one of a fixed set of preallocated SPSC fifos (like Counters),
+     * so the probe is wait-free, even with several plugin instances processing at once.
+     * The inspector drains them on the message thread into a timeline and a histogram of load
+     * per processor, where 100% load is a likely xrun. Nothing is recorded while no panel is open.
+     */
+    class ProcessBlockTimes
+    {
+    public:
+        static constexpr int maxThreads = 32;
+        static constexpr int fifoSize = 1024;
+        static constexpr size_t maxProcessors = 4;
+        static constexpr size_t historySize = 4096;
+        static constexpr size_t numBins = 16; // 10% each, the last one is 150% and up
+        static constexpr float riskyLoad = 0.7f;
+
+        struct Block
+        {
+            const juce::AudioProcessor* processor = nullptr;
+            double startMs = 0;
+            float durationMs = 0;
+            float deadlineMs = 0;
+
+            [[nodiscard]] float getLoad() const { return deadlineMs > 0 ? durationMs / deadlineMs : 0; }
+        };
+
+        // what's been drained for one processor
+        class History
+        {
+        public:
+            [[nodiscard]] size_t size() const { return (size_t) juce::jmin (total, (juce::uint64) historySize); }
+
+            // 0 is the most recent block
+            [[nodiscard]] const Block& get (size_t blocksAgo) const
+            {
+                jassert (blocksAgo < size());
+                return blocks[(size_t) ((total - 1 - blocksAgo) % historySize)];
+            }
+
+            [[nodiscard]] juce::uint64 getNumBlocks() const noexcept { return total; }
+            [[nodiscard]] juce::uint64 getBin (size_t index) const { return bins[index]; }
+            [[nodiscard]] juce::uint64 getNumRisky() const noexcept { return risky; }
+            [[nodiscard]] juce::uint64 getNumOverruns() const noexcept { return overruns; }
+            [[nodiscard]] float getWorstLoad() const noexcept { return worstLoad; }
+
+        private:
+            friend class ProcessBlockTimes;
+
+            const juce::AudioProcessor* processor = nullptr;
+            std::array<Block, historySize> blocks {};
+            juce::uint64 total = 0;
+            std::array<juce::uint64, numBins> bins {};
+            juce::uint64 risky = 0;
+            juce::uint64 overruns = 0;
+            float worstLoad = 0;
+
+            void reset()
+            {
+                processor = nullptr;
+                total = 0;
+                bins.fill (0);
+                risky = 0;
+                overruns = 0;
+                worstLoad = 0;
+            }
+
+            void add (const Block& block)
+            {
+                blocks[(size_t) (total++ % historySize)] = block;
+
+                auto load = block.getLoad();
+                ++bins[juce::jlimit ((size_t) 0, numBins - 1, (size_t) (load * 10.0f))];
+                risky += load > riskyLoad ? 1 : 0;
+                overruns += load > 1.0f ? 1 : 0;
+                worstLoad = juce::jmax (worstLoad, load);
+            }
+        };
+
+        static ProcessBlockTimes& getInstance()
+        {
+            static ProcessBlockTimes times;
+            return times;
+        }
+
+        // audio thread
+        void push (const Block& block)
+        {
+            if (!recording.load (std::memory_order_relaxed))
+                return;
+
+            thread_local ThreadFifo* fifo = claimFifo();
+            if (fifo == nullptr)
+                return;
+
+            const auto scope = fifo->abstractFifo.write (1);
+            if (scope.blockSize1 == 0)
+            {
+                dropped.fetch_add (1, std::memory_order_relaxed);
+                return;
+            }
+
+            fifo->blocks[(size_t) scope.startIndex1] = block;
+        }
+
+        // message thread only, from here on
+
+        // the panels record while they're open
+        void startRecording()
+        {
+            if (recorders++ == 0)
+            {
+                drain(); // whatever's left from last time is stale
+                recording = true;
+            }
+        }
+
+        void stopRecording()
+        {
+            jassert (recorders > 0);
+            if (--recorders == 0)
+                recording = false;
+        }
+
+        // every processor's blocks go to their own history
+        void drain()
+        {
+            auto numFifos = juce::jmin (claimed.load(), maxThreads);
+            for (size_t i = 0; i < (size_t) numFifos; ++i)
+            {
+                auto& fifo = fifos[i];
+                const auto scope = fifo.abstractFifo.read (fifo.abstractFifo.getNumReady());
+                scope.forEach ([&] (int index) {
+                    auto& block = fifo.blocks[(size_t) index];
+                    if (auto* h = getHistoryFor (block.processor))
+                        h->add (block);
+                    else
+                        dropped.fetch_add (1, std::memory_order_relaxed);
+                });
+            }
+        }
+
+        // returns nullptr when nothing's been drained for this processor
+        [[nodiscard]] const History* find (const juce::AudioProcessor* processor) const
+        {
+            for (auto& h : histories)
+                if (h.processor == processor && processor != nullptr)
+                    return &h;
+            return nullptr;
+        }
+
+        // forgets the processor, its slot can then be taken by another
+        void clear (const juce::AudioProcessor* processor)
+        {
+            for (auto& h : histories)
+                if (h.processor == processor)
+                    h.reset();
+        }
+
+        // blocks that didn't fit, because nobody drained in time, or too many threads or processors recorded
+        [[nodiscard]] juce::uint64 getNumDropped() const { return dropped.load(); }
+
+    private:
+        struct ThreadFifo
+        {
+            juce::AbstractFifo abstractFifo { fifoSize };
+            std::array<Block, fifoSize> blocks {};
+        };
+
+        // all preallocated, as the first block comes from the audio thread
+        std::array<ThreadFifo, maxThreads> fifos;
+        std::atomic<int> claimed { 0 };
+        std::atomic<juce::uint64> dropped { 0 };
+        std::atomic<bool> recording { false };
+        int recorders = 0;
+
+        std::array<History, maxProcessors> histories;
+
+        ProcessBlockTimes() = default;
+
+        // threads keep their fifo for good, so hosts that keep spawning audio threads will eventually run out
+        ThreadFifo* claimFifo()
+        {
+            auto index = claimed.fetch_add (1);
+            if (index < maxThreads)
+                return &fifos[(size_t) index];
+
+            jassertfalse; // more than maxThreads threads are processing
+            return nullptr;
+        }
+
+        History* getHistoryFor (const juce::AudioProcessor* processor)
+        {
+            History* empty = nullptr;
+            for (auto& h : histories)
+            {
+                if (h.processor == processor)
+                    return &h;
+                if (h.processor == nullptr && empty == nullptr)
+                    empty = &h;
+            }
+
+            if (empty != nullptr)
+                empty->processor = processor;
+            return empty;
+        }
+
+        JUCE_DECLARE_NON_COPYABLE (ProcessBlockTimes)
+    };
+
+    /*
+     * Put this at the top of your processBlock:
+     *
+     *     melatonin::ProcessBlockProbe probe (*this, buffer.getNumSamples());
+     */
+    class ProcessBlockProbe
+    {
+    public:
+        ProcessBlockProbe (const juce::AudioProcessor& p, int numSamples)
+            : processor (p),
+              deadlineMs (p.getSampleRate() > 0 ? 1000.0 * (double) numSamples / p.getSampleRate() : 0),
+              startMs (juce::Time::getMillisecondCounterHiRes())
+        {
+        }
+
+        ~ProcessBlockProbe()
+        {
+            auto durationMs = juce::Time::getMillisecondCounterHiRes() - startMs;
+            ProcessBlockTimes::getInstance().push ({ &processor, startMs, (float) durationMs, (float) deadlineMs });
+        }
+
+    private:
+        const juce::AudioProcessor& processor;
+        double deadlineMs;
+        double startMs;
+
+        JUCE_DECLARE_NON_COPYABLE (ProcessBlockProbe)
+    };
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <juce_gui_basics/juce_gui_basics.h>
+
+namespace melatonin
+{
+    /*
+     * Sweeping over a big UI selects dozens of components a second.
+     * Work that renders the selection offscreen waits until the requests settle,
+     * or runs at most every maxWaitMs while they don't.
+     */
+    class SettleTimer : private juce::Timer
+    {
+    public:
+        static constexpr double settleMs = 80;
+        static constexpr double maxWaitMs = 250;
+
+        std::function<void()> onSettled;
+
+        SettleTimer() = default;
+
+        void request()
+        {
+            auto nowMs = juce::Time::getMillisecondCounterHiRes();
+            lastRequestMs = nowMs;
+
+            if (!pending)
+            {
+                pending = true;
+                firstRequestMs = nowMs;
+                startTimer (20);
+            }
+        }
+
+        void cancel()
+        {
+            stopTimer();
+            pending = false;
+        }
+
+        [[nodiscard]] bool isPending() const noexcept { return pending; }
+
+    private:
+        bool pending = false;
+        double firstRequestMs = 0;
+        double lastRequestMs = 0;
+
+        void timerCallback() override
+        {
+            auto nowMs = juce::Time::getMillisecondCounterHiRes();
+            if (nowMs - lastRequestMs < settleMs && nowMs - firstRequestMs < maxWaitMs)
+                return;
+
+            cancel();
+            if (onSettled)
+                onSettled();
+        }
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SettleTimer)
+    };
+}
@@ -1,37 +1,242 @@
 #pragma once
+#include "frame_recorder.h"
+#include "timing_table.h"
 #include <juce_gui_basics/juce_gui_basics.h>
 
+#if MELATONIN_TRACE
+    #include "trace.h"
+#endif
+
 namespace melatonin
 {
-    class ComponentTimer
+    /*
+     * Each thread keeps a stack of the timers that are "open"
+     *
+     * A timer that starts while another is running is nested inside it,
+     * so its time is subtracted from the parent's exclusive time.
+     *
+     * A finished timer stays on the stack (collecting the inclusive time of any
+     * timed descendants that paint afterwards, even through untimed components)
+     * until something outside its subtree paints or the paint pass is over.
+     */
+    class TimerStack
     {
     public:
-        explicit ComponentTimer (juce::Component* c) : component (c)
+        static constexpr size_t maxDepth = 64;
+
+        static TimerStack& getForThisThread()
         {
-            startTimeTicks = juce::Time::getHighResolutionTicks();
+            thread_local TimerStack stack;
+            return stack;
         }
 
-        ~ComponentTimer()
+        // the innermost component being timed on the message thread, for the stall watchdog
+        // other threads may only compare the pointer, never dereference it
+        static std::atomic<const juce::Component*>& getPaintingOnMessageThread()
+        {
+            static std::atomic<const juce::Component*> painting { nullptr };
+            return painting;
+        }
+
+        void push (juce::Component* c)
+        {
+            auto now = juce::Time::getHighResolutionTicks();
+
+            // finished timers that aren't our ancestors are done collecting descendants
+            while (size > 0 && !frames[size - 1].running && !isAncestorOf (frames[size - 1], c))
+                close();
+
+            if (size == 0)
+                scheduleFlush();
+
+            // paused, too deep, or already timing this component (e.g. both a manual and an automatic timer)
+            if (pauseDepth > 0 || size == maxDepth || (size > 0 && frames[size - 1].running && frames[size - 1].component == c))
+            {
+                ++ignored;
+                return;
+            }
+
+            auto& frame = frames[size++];
+            frame = Frame();
+            frame.component = c;
+            frame.entry = TimingTable::getInstance().getOrCreate (c);
+            frame.startTicks = now;
+
+            if (isMessageThread)
+                getPaintingOnMessageThread().store (c, std::memory_order_relaxed);
+        }
+
+        void pop()
+        {
+            auto now = juce::Time::getHighResolutionTicks();
+
+            if (ignored > 0)
+            {
+                --ignored;
+                return;
+            }
+
+            // timers nested inside this one have finished
+            while (size > 0 && !frames[size - 1].running)
+                close();
+
+            if (size == 0)
+            {
+                jassertfalse; // unbalanced push/pop
+                return;
+            }
+
+            auto& frame = frames[size - 1];
+            frame.ownTicks = now - frame.startTicks;
+            frame.endTicks = juce::jmax (frame.endTicks, now);
+            frame.running = false;
+
+            if (isMessageThread)
+                getPaintingOnMessageThread().store (getInnermostRunning(), std::memory_order_relaxed);
+
+            if (isValid (frame))
+            {
+                auto exclusiveSeconds = toSeconds (frame.ownTicks - frame.nestedTicks);
+                frame.entry->exclusive.record (exclusiveSeconds);
+                frame.entry->paintSeconds += exclusiveSeconds;
+            }
+        }
+
+        // records the inclusive time of everything waiting on the stack
+        void flush()
+        {
+            while (size > 0 && !frames[size - 1].running)
+                close();
+
+            if (size == 0 && isMessageThread)
+                FrameRecorder::getInstance().endFrame();
+        }
+
+    private:
+        struct Frame
+        {
+            const juce::Component* component = nullptr;
+            TimingTable::Entry* entry = nullptr;
+            juce::int64 startTicks = 0;
+            juce::int64 ownTicks = 0;
+            juce::int64 nestedTicks = 0; // descendants painted while we were running
+            juce::int64 afterTicks = 0; // descendants painted after we finished
+            juce::int64 endTicks = 0; // when we or our last descendant finished
+            bool running = true;
+        };
+
+        // only the message thread flushes, as that's where painting happens
+        struct Flusher : public juce::AsyncUpdater
+        {
+            void handleAsyncUpdate() override { TimerStack::getForThisThread().flush(); }
+        };
+
+        std::array<Frame, maxDepth> frames;
+        size_t size = 0;
+        int ignored = 0;
+        int pauseDepth = 0;
+
+        // the flame chart only records paints on the message thread
+        bool isMessageThread = false;
+
+        friend class ScopedTimingPause;
+
+        TimerStack() = default;
+
+        void close()
+        {
+            auto frame = frames[--size];
+            auto inclusiveTicks = frame.ownTicks + frame.afterTicks;
+
+            if (isValid (frame))
+            {
+                frame.entry->inclusive.record (toSeconds (inclusiveTicks));
+                if (isMessageThread)
+                    FrameRecorder::getInstance().addSpan (frame.component, size, frame.startTicks, frame.startTicks + frame.ownTicks, frame.endTicks);
+            }
+
+            if (size > 0)
+            {
+                auto& parent = frames[size - 1];
+                parent.endTicks = juce::jmax (parent.endTicks, frame.endTicks);
+                if (parent.running)
+                    parent.nestedTicks += inclusiveTicks;
+                else
+                    parent.afterTicks += inclusiveTicks;
+            }
+        }
+
+        // the table slot may have been recycled if the component was deleted mid-paint
+        static bool isValid (const Frame& frame)
+        {
+            return frame.entry != nullptr && frame.entry->key == frame.component && frame.entry->isAlive();
+        }
+
+        static bool isAncestorOf (const Frame& frame, const juce::Component* c)
+        {
+            return isValid (frame) && frame.entry->component->isParentOf (c);
+        }
+
+        void scheduleFlush()
+        {
+            if (!juce::MessageManager::existsAndIsCurrentThread())
+                return;
+
+            isMessageThread = true;
+            static Flusher flusher;
+            flusher.triggerAsyncUpdate();
+        }
+
+        [[nodiscard]] const juce::Component* getInnermostRunning() const
+        {
+            for (auto i = size; i > 0; --i)
+                if (frames[i - 1].running)
+                    return frames[i - 1].component;
+
+            return nullptr;
+        }
+
+        static double toSeconds (juce::int64 ticks)
         {
             static double scalar = 1.0 / static_cast<double> (juce::Time::getHighResolutionTicksPerSecond());
-            result = static_cast<double> (juce::Time::getHighResolutionTicks() - startTimeTicks) * scalar;
+            return static_cast<double> (ticks) * scalar;
+        }
 
-            auto& props = component->getProperties();
+        JUCE_DECLARE_NON_COPYABLE (TimerStack)
+    };
 
-            // if this new time is slower, make it the max
-            if (result > (double) props.getWithDefault ("timing1", 0.0))
-                props.set ("timingMax", result);
+    // Paints that happen in this scope aren't recorded
+    // The inspector uses this when it snapshots components for its own display
+    class ScopedTimingPause
+    {
+    public:
+        ScopedTimingPause() { ++TimerStack::getForThisThread().pauseDepth; }
+        ~ScopedTimingPause() { --TimerStack::getForThisThread().pauseDepth; }
+
+    private:
+        JUCE_DECLARE_NON_COPYABLE (ScopedTimingPause)
+    };
 
-            // push the 1st and 2nd timings down
-            props.set ("timing3", props.getWithDefault ("timing2", 0.0));
-            props.set ("timing2", props.getWithDefault ("timing1", 0.0));
-            props.set ("timing1", result);
+    class ComponentTimer
+    {
+    public:
+        explicit ComponentTimer (juce::Component* c)
+        {
+#if MELATONIN_TRACE
+            Trace::beginComponent (*c);
+#endif
+            TimerStack::getForThisThread().push (c);
+        }
+
+        ~ComponentTimer()
+        {
+            TimerStack::getForThisThread().pop();
+#if MELATONIN_TRACE
+            Trace::end ("component");
+#endif
         }
 
     private:
-        juce::Component* component;
-        juce::int64 startTimeTicks;
-        double result = 0;
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ComponentTimer)
     };
 
@@ -0,0 +1,104 @@
+#pragma once
+#include <juce_core/juce_core.h>
+
+namespace melatonin
+{
+    // A fixed memory, log bucketed histogram in the spirit of HdrHistogram
+    // Each power of two (in microseconds) is split into a few linear sub-buckets
+    // This keeps percentiles within ~12% from 1µs to ~1s without ever allocating
+    class TimingHistogram
+    {
+    public:
+        static constexpr int subBucketsPerOctave = 4;
+        static constexpr int numOctaves = 20; // 1µs to 2^20µs (~1s)
+        static constexpr int numBuckets = subBucketsPerOctave * numOctaves + 1; // first bucket is sub-µs
+
+        struct Summary
+        {
+            double p50 = 0;
+            double p90 = 0;
+            double p99 = 0;
+            double max = 0;
+            juce::uint64 count = 0;
+        };
+
+        void record (double seconds) noexcept
+        {
+            ++counts[(size_t) bucketFor (seconds)];
+            ++total;
+
+            if (seconds > max)
+                max = seconds;
+        }
+
+        void reset() noexcept
+        {
+            counts.fill (0);
+            total = 0;
+            max = 0;
+        }
+
+        [[nodiscard]] juce::uint64 getCount() const noexcept { return total; }
+        [[nodiscard]] double getMax() const noexcept { return max; }
+
+        // returns the midpoint of the bucket the percentile falls in (in seconds)
+        [[nodiscard]] double getPercentile (double percentile) const noexcept
+        {
+            if (total == 0)
+                return 0;
+
+            // rank is 1 based, the p99 of 100 samples is the 99th sample
+            auto rank = juce::jmax ((juce::uint64) 1, (juce::uint64) std::ceil (percentile / 100.0 * (double) total));
+            juce::uint64 seen = 0;
+
+            for (int i = 0; i < numBuckets; ++i)
+            {
+                seen += counts[(size_t) i];
+                // the last bucket is open ended, so report the real max
+                if (seen >= rank)
+                    return i == numBuckets - 1 ? max : juce::jmin (bucketMidpoint (i), max);
+            }
+
+            return max;
+        }
+
+        [[nodiscard]] Summary summarize() const noexcept
+        {
+            return { getPercentile (50), getPercentile (90), getPercentile (99), max, total };
+        }
+
+    private:
+        std::array<juce::uint32, numBuckets> counts {};
+        juce::uint64 total = 0;
+        double max = 0;
+
+        static int bucketFor (double seconds) noexcept
+        {
+            auto us = seconds * 1000.0 * 1000.0;
+            if (us < 1.0)
+                return 0;
+
+            int exponent = 0;
+            auto mantissa = std::frexp (us, &exponent); // us = mantissa * 2^exponent, mantissa in [0.5, 1)
+            auto octave = exponent - 1;
+
+            if (octave >= numOctaves)
+                return numBuckets - 1;
+
+            auto subBucket = (int) ((mantissa * 2.0 - 1.0) * subBucketsPerOctave);
+            return 1 + octave * subBucketsPerOctave + juce::jmin (subBucket, subBucketsPerOctave - 1);
+        }
+
+        static double bucketMidpoint (int bucket) noexcept
+        {
+            if (bucket == 0)
+                return 0.5 / (1000.0 * 1000.0);
+
+            auto octave = (bucket - 1) / subBucketsPerOctave;
+            auto subBucket = (bucket - 1) % subBucketsPerOctave;
+            auto octaveStart = std::ldexp (1.0, octave);
+            auto width = octaveStart / subBucketsPerOctave;
+            return (octaveStart + width * (subBucket + 0.5)) / (1000.0 * 1000.0);
+        }
+    };
+}
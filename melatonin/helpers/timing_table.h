@@ -0,0 +1,202 @@
+#pragma once
+#include "timing_histogram.h"
+#include <juce_gui_basics/juce_gui_basics.h>
+
+// Number of components that can be timed at once, must be a power of 2
+#ifndef MELATONIN_TIMING_TABLE_SIZE
+    #define MELATONIN_TIMING_TABLE_SIZE 4096
+#endif
+
+namespace melatonin
+{
+    // Paint timings live here rather than in the component's NamedValueSet
+    // It's a flat, open addressed map keyed by component pointer
+    // The storage is allocated once, so recording a paint never touches the heap
+    // Only access this from the message thread (or with the MessageManager locked)
+    class TimingTable
+    {
+    public:
+        static constexpr size_t capacity = MELATONIN_TIMING_TABLE_SIZE;
+        static_assert ((capacity & (capacity - 1)) == 0, "MELATONIN_TIMING_TABLE_SIZE must be a power of 2");
+
+        struct Entry
+        {
+            const juce::Component* key = nullptr;
+
+            // lets us notice when the component is deleted (or another one reuses its address)
+            juce::Component::SafePointer<juce::Component> component;
+
+            // exclusive is the component's own paint, inclusive adds its (timed) descendants
+            TimingHistogram exclusive;
+            TimingHistogram inclusive;
+
+            // repaint() calls made by this component (not its children) since the last sample
+            juce::uint32 repaints = 0;
+            juce::uint64 repaintedPixels = 0;
+
+            // exclusive paint time since the last sample
+            double paintSeconds = 0;
+
+            // bumped by repaints of the component or any of its descendants, never reset
+            // lets cached renders of the component know when they're stale
+            juce::uint64 invalidations = 0;
+
+            // updated once per sample
+            float repaintsPerSecond = 0;
+            float repaintedPixelsPerSecond = 0;
+            float paintMsPerSecond = 0;
+
+            [[nodiscard]] bool isAlive() const noexcept { return component != nullptr; }
+
+            void reset (juce::Component* c)
+            {
+                key = c;
+                component = c;
+                exclusive.reset();
+                inclusive.reset();
+                repaints = 0;
+                repaintedPixels = 0;
+                paintSeconds = 0;
+                invalidations = 0;
+                repaintsPerSecond = 0;
+                repaintedPixelsPerSecond = 0;
+                paintMsPerSecond = 0;
+            }
+        };
+
+        static TimingTable& getInstance()
+        {
+            static TimingTable table;
+            return table;
+        }
+
+        // returns nullptr when the table is full
+        Entry* getOrCreate (juce::Component* c)
+        {
+            Entry* recyclable = nullptr;
+
+            for (size_t i = 0, slot = indexFor (c); i < capacity; ++i, slot = (slot + 1) & (capacity - 1))
+            {
+                auto& entry = entries[slot];
+
+                if (entry.key == c)
+                {
+                    // a new component was allocated where a deleted one used to live
+                    if (!entry.isAlive())
+                        entry.reset (c);
+
+                    return &entry;
+                }
+
+                if (entry.key == nullptr)
+                {
+                    auto& fresh = recyclable != nullptr ? *recyclable : entry;
+                    fresh.reset (c);
+                    return &fresh;
+                }
+
+                // deleted components leave their slot behind for reuse
+                // (we can't empty it without breaking the probe chain)
+                if (recyclable == nullptr && !entry.isAlive())
+                    recyclable = &entry;
+            }
+
+            if (recyclable != nullptr)
+            {
+                recyclable->reset (c);
+                return recyclable;
+            }
+
+            // more than MELATONIN_TIMING_TABLE_SIZE components are being timed
+            jassertfalse;
+            return nullptr;
+        }
+
+        // returns nullptr if the component has never been timed
+        Entry* find (const juce::Component* c)
+        {
+            if (c == nullptr)
+                return nullptr;
+
+            for (size_t i = 0, slot = indexFor (c); i < capacity; ++i, slot = (slot + 1) & (capacity - 1))
+            {
+                auto& entry = entries[slot];
+
+                if (entry.key == c)
+                    return entry.isAlive() ? &entry : nullptr;
+
+                if (entry.key == nullptr)
+                    return nullptr;
+            }
+
+            return nullptr;
+        }
+
+        // turns the repaint counts and paint time into rates and starts counting again
+        // both automatic timings and the HUD sample, so samples closer than half a second are skipped
+        void sample()
+        {
+            auto now = juce::Time::getMillisecondCounterHiRes();
+            auto elapsedSeconds = (now - lastSampleMs) / 1000.0;
+            if (elapsedSeconds < 0.5)
+                return;
+
+            lastSampleMs = now;
+
+            for (auto& entry : entries)
+            {
+                if (!entry.isAlive())
+                    continue;
+
+                entry.repaintsPerSecond = (float) (entry.repaints / elapsedSeconds);
+                entry.repaintedPixelsPerSecond = (float) ((double) entry.repaintedPixels / elapsedSeconds);
+                entry.paintMsPerSecond = (float) (entry.paintSeconds * 1000.0 / elapsedSeconds);
+                entry.repaints = 0;
+                entry.repaintedPixels = 0;
+                entry.paintSeconds = 0;
+            }
+        }
+
+        // the components that spent the most time in their own paint during the last sample, most expensive first
+        template <size_t N>
+        void findMostExpensive (std::array<const Entry*, N>& result) const
+        {
+            result.fill (nullptr);
+
+            for (auto& entry : entries)
+            {
+                if (!entry.isAlive() || entry.paintMsPerSecond <= 0)
+                    continue;
+
+                // insertion sort into the (tiny) result
+                const Entry* candidate = &entry;
+                for (auto& slot : result)
+                {
+                    if (slot == nullptr)
+                    {
+                        slot = candidate;
+                        break;
+                    }
+
+                    if (candidate->paintMsPerSecond > slot->paintMsPerSecond)
+                        std::swap (slot, candidate);
+                }
+            }
+        }
+
+    private:
+        std::vector<Entry> entries = std::vector<Entry> (capacity);
+        double lastSampleMs = juce::Time::getMillisecondCounterHiRes();
+
+        TimingTable() = default;
+
+        static size_t indexFor (const juce::Component* c) noexcept
+        {
+            // fibonacci hashing spreads out the (aligned) pointer values
+            auto hash = (juce::uint64) reinterpret_cast<juce::pointer_sized_uint> (c) * 11400714819323198485ull;
+            return (size_t) (hash >> 32) & (capacity - 1);
+        }
+
+        JUCE_DECLARE_NON_COPYABLE (TimingTable)
+    };
+}
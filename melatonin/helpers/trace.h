@@ -0,0 +1,306 @@
+#pragma once
+#include "component_helpers.h"
+#include <juce_gui_basics/juce_gui_basics.h>
+
+// Set to 1 to record TRACE_COMPONENT, TRACE_EVENT and ComponentTimer without Perfetto
+#ifndef MELATONIN_TRACE
+    #define MELATONIN_TRACE 0
+#endif
+
+// Events kept per thread, must be a power of 2
+#ifndef MELATONIN_TRACE_BUFFER_SIZE
+    #define MELATONIN_TRACE_BUFFER_SIZE 8192
+#endif
+
+// Threads that can record, events from any more threads are dropped
+#ifndef MELATONIN_TRACE_MAX_THREADS
+    #define MELATONIN_TRACE_MAX_THREADS 16
+#endif
+
+#if defined(_MSC_VER)
+    #define MELATONIN_TRACE_FUNCTION __FUNCSIG__
+#else
+    #define MELATONIN_TRACE_FUNCTION __PRETTY_FUNCTION__
+#endif
+
+namespace melatonin
+{
+    /*
+     * A tiny stand-in for Perfetto.
+     *
+     * Each thread claims one of a fixed pool of rings with a single atomic increment
+     * and writes begin/end events into it, so recording never locks or allocates,
+     * not even on a thread's first event. The pool is zero initialized static storage.
+     * When a ring is full, the oldest events are overwritten.
+     * Call writeTo() at any time to get a Chrome JSON trace,
+     * which opens in https://ui.perfetto.dev or chrome://tracing
+     */
+    class Trace
+    {
+    public:
+        static constexpr size_t bufferSize = MELATONIN_TRACE_BUFFER_SIZE;
+        static constexpr int maxThreads = MELATONIN_TRACE_MAX_THREADS;
+        static_assert ((bufferSize & (bufferSize - 1)) == 0, "MELATONIN_TRACE_BUFFER_SIZE must be a power of 2");
+
+        struct Event
+        {
+            juce::int64 ticks = 0;
+            const char* category = nullptr;
+
+            // names are either static strings (like Perfetto requires), a component's type or a copy
+            const char* name = nullptr;
+            const std::type_info* type = nullptr;
+            std::array<char, 32> copiedName {};
+
+            char phase = 0;
+        };
+
+        // string literals and __PRETTY_FUNCTION__ are stored as pointers
+        static void begin (const char* category, const char* name)
+        {
+            record (category, 'B', [&] (Event& event) { event.name = name; });
+        }
+
+        static void begin (const char* category, const juce::String& name)
+        {
+            record (category, 'B', [&] (Event& event) { name.copyToUTF8 (event.copiedName.data(), event.copiedName.size()); });
+        }
+
+        static void begin (const char* category, const std::string& name)
+        {
+            record (category, 'B', [&] (Event& event) {
+                name.copy (event.copiedName.data(), event.copiedName.size() - 1);
+                event.copiedName[juce::jmin (name.size(), event.copiedName.size() - 1)] = '\0';
+            });
+        }
+
+        // named after the component, or its type when it has no name
+        static void beginComponent (const juce::Component& component)
+        {
+            record ("component", 'B', [&] (Event& event) {
+                if (component.getName().isNotEmpty())
+                    component.getName().copyToUTF8 (event.copiedName.data(), event.copiedName.size());
+                else
+                    event.type = &typeid (component);
+            });
+        }
+
+        static void end (const char* category)
+        {
+            record (category, 'E', [] (Event&) {});
+        }
+
+        // Perfetto debug annotations aren't recorded
+        template <typename Name, typename Annotation, typename... Annotations>
+        static void begin (const char* category, const Name& name, const Annotation&, const Annotations&...)
+        {
+            begin (category, name);
+        }
+
+        // safe to call from any thread while others keep recording
+        static bool writeTo (const juce::File& file)
+        {
+            juce::FileOutputStream out (file);
+            if (!out.openedOk())
+                return false;
+
+            out.setPosition (0);
+            out.truncate();
+            out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+            auto& trace = getInstance();
+            auto numBuffers = juce::jmin (trace.claimed.load(), maxThreads);
+            std::vector<std::vector<Event>> events ((size_t) numBuffers);
+            for (size_t i = 0; i < events.size(); ++i)
+                trace.buffers[i].copyTo (events[i]);
+
+            // timestamps start at the earliest event we have
+            auto origin = std::numeric_limits<juce::int64>::max();
+            for (auto& bufferEvents : events)
+                if (!bufferEvents.empty())
+                    origin = juce::jmin (origin, bufferEvents.front().ticks);
+
+            bool first = true;
+            auto writeLine = [&] (const juce::String& line) {
+                out << (first ? "" : ",\n") << line;
+                first = false;
+            };
+
+            for (size_t i = 0; i < events.size(); ++i)
+            {
+                // the name is written before the first event is published, so only read it after one
+                if (events[i].empty())
+                    continue;
+
+                auto& buffer = trace.buffers[i];
+                auto tid = juce::String ((int) i + 1);
+                writeLine ("{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" + tid
+                           + ",\"args\":{\"name\":" + juce::JSON::toString (buffer.getThreadName ((int) i + 1)) + "}}");
+
+                for (auto& event : events[i])
+                {
+                    auto micros = juce::Time::highResolutionTicksToSeconds (event.ticks - origin) * 1000000.0;
+                    auto line = juce::String ("{\"ph\":\"") + event.phase
+                                + "\",\"cat\":\"" + event.category
+                                + "\",\"ts\":" + juce::String (micros, 3)
+                                + ",\"pid\":1,\"tid\":" + tid;
+
+                    if (event.phase == 'B')
+                        line << ",\"name\":" << juce::JSON::toString (getName (event));
+
+                    writeLine (line + "}");
+                }
+            }
+
+            out << "\n]}\n";
+            out.flush();
+            return out.getStatus().wasOk();
+        }
+
+    private:
+        class Buffer
+        {
+        public:
+            // the owning thread fills in the event, then commits it
+            Event& prepare (const char* category, char phase)
+            {
+                auto& event = events[(size_t) (writeIndex.load (std::memory_order_relaxed) & (bufferSize - 1))];
+                event.ticks = juce::Time::getHighResolutionTicks();
+                event.category = category;
+                event.name = nullptr;
+                event.type = nullptr;
+                event.copiedName[0] = '\0';
+                event.phase = phase;
+                return event;
+            }
+
+            // publishes the event to writeTo
+            void commit()
+            {
+                writeIndex.store (writeIndex.load (std::memory_order_relaxed) + 1, std::memory_order_release);
+            }
+
+            // called once by the thread that claimed the buffer, before its first event
+            // copying a juce::String only bumps its ref count, so this doesn't allocate either
+            void claimForThisThread()
+            {
+                isMessageThread = juce::MessageManager::existsAndIsCurrentThread();
+                if (auto* thread = juce::Thread::getCurrentThread())
+                    thread->getThreadName().copyToUTF8 (threadName.data(), threadName.size());
+            }
+
+            // the owning thread may lap us while we copy, so anything it could have touched is dropped
+            void copyTo (std::vector<Event>& dest) const
+            {
+                dest.clear();
+                auto written = writeIndex.load (std::memory_order_acquire);
+                auto start = written > bufferSize ? written - bufferSize : 0;
+                for (auto i = start; i < written; ++i)
+                    dest.push_back (events[(size_t) (i & (bufferSize - 1))]);
+
+                std::atomic_thread_fence (std::memory_order_acquire);
+                auto writtenAfterCopy = writeIndex.load (std::memory_order_relaxed);
+
+                // +1 as the event being prepared is overwritten before the index moves
+                auto firstIntact = writtenAfterCopy + 1 > bufferSize ? writtenAfterCopy + 1 - bufferSize : 0;
+                if (firstIntact > start)
+                    dest.erase (dest.begin(), dest.begin() + (std::ptrdiff_t) juce::jmin (firstIntact - start, (juce::uint64) dest.size()));
+            }
+
+            [[nodiscard]] juce::String getThreadName (int id) const
+            {
+                if (isMessageThread)
+                    return "Message Thread";
+                if (threadName[0] != '\0')
+                    return juce::String::fromUTF8 (threadName.data());
+                return "Thread " + juce::String (id);
+            }
+
+        private:
+            std::array<Event, bufferSize> events {};
+            std::atomic<juce::uint64> writeIndex { 0 };
+            std::array<char, 32> threadName {};
+            bool isMessageThread = false;
+        };
+
+        // all zeros, so it's constant initialized and costs nothing until it's written to
+        std::array<Buffer, maxThreads> buffers {};
+        std::atomic<int> claimed { 0 };
+
+        static Trace& getInstance()
+        {
+            static Trace trace;
+            return trace;
+        }
+
+        // threads keep their buffer for good, so events outlive the threads that wrote them
+        // once the pool is used up, threads that come later aren't recorded
+        static Buffer* getForThisThread()
+        {
+            thread_local Buffer* buffer = getInstance().claimBuffer();
+            return buffer;
+        }
+
+        Buffer* claimBuffer()
+        {
+            auto index = claimed.fetch_add (1);
+            if (index >= maxThreads)
+                return nullptr;
+
+            auto* buffer = &buffers[(size_t) index];
+            buffer->claimForThisThread();
+            return buffer;
+        }
+
+        template <typename Fill>
+        static void record (const char* category, char phase, Fill&& fill)
+        {
+            if (auto* buffer = getForThisThread())
+            {
+                fill (buffer->prepare (category, phase));
+                buffer->commit();
+            }
+        }
+
+        // "virtual void melatonin::Preview::paint(juce::Graphics &)" becomes "melatonin::Preview::paint"
+        static juce::String getName (const Event& event)
+        {
+            if (event.type != nullptr)
+                return typeName (*event.type);
+
+            if (event.name == nullptr)
+                return juce::String::fromUTF8 (event.copiedName.data());
+
+            auto name = juce::String (event.name).upToFirstOccurrenceOf ("(", false, false);
+            return name.fromLastOccurrenceOf (" ", false, false);
+        }
+
+        constexpr Trace() = default;
+
+        JUCE_DECLARE_NON_COPYABLE (Trace)
+    };
+
+    class ScopedTrace
+    {
+    public:
+        template <typename... Args>
+        explicit ScopedTrace (const char* c, const Args&... args) : category (c)
+        {
+            Trace::begin (category, args...);
+        }
+
+        ~ScopedTrace()
+        {
+            Trace::end (category);
+        }
+
+    private:
+        const char* category;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedTrace)
+    };
+}
+
+#define MELATONIN_TRACE_CONCAT_INNER(a, b) a##b
+#define MELATONIN_TRACE_CONCAT(a, b) MELATONIN_TRACE_CONCAT_INNER (a, b)
+#define MELATONIN_TRACE_SCOPE(...) melatonin::ScopedTrace MELATONIN_TRACE_CONCAT (melatonin_trace_, __LINE__) (__VA_ARGS__)
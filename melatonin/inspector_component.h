@@ -6,7 +6,16 @@
 #include "melatonin_inspector/melatonin/components/box_model.h"
 #include "melatonin_inspector/melatonin/components/color_picker.h"
 #include "melatonin_inspector/melatonin/components/component_tree_view_item.h"
+#include "melatonin_inspector/melatonin/components/flame_chart.h"
+#include "melatonin_inspector/melatonin/components/frame_times.h"
+#include "melatonin_inspector/melatonin/components/message_thread.h"
+#include "melatonin_inspector/melatonin/components/graphics_calls.h"
+#include "melatonin_inspector/melatonin/components/pill_toggle.h"
 #include "melatonin_inspector/melatonin/components/preview.h"
+#if JUCE_MODULE_AVAILABLE_juce_audio_processors
+    #include "melatonin_inspector/melatonin/components/parameter_changes.h"
+    #include "melatonin_inspector/melatonin/components/processor_load.h"
+#endif
 #include "melatonin_inspector/melatonin/components/properties.h"
 #include "melatonin_inspector/melatonin/lookandfeel.h"
 
@@ -24,6 +33,9 @@ namespace melatonin
         {
             TRACE_COMPONENT();
 
+            // dragging or animating the selected component updates the panels once per frame at most
+            model.coalesceOnVBlankOf (*this);
+
             setMouseClickGrabsKeyboardFocus (false);
 
             addAndMakeVisible (enabledButton);
@@ -42,6 +54,14 @@ namespace melatonin
             addChildComponent (boxModel);
             addChildComponent (colorPicker);
             addChildComponent (preview);
+            addChildComponent (graphicsCalls);
+            addChildComponent (flameChart);
+            addChildComponent (frameTimes);
+            addChildComponent (messageThread);
+#if JUCE_MODULE_AVAILABLE_juce_audio_processors
+            addChildComponent (processorLoad);
+            addChildComponent (parameterChanges);
+#endif
             addChildComponent (properties);
             addChildComponent (accessibility);
 
@@ -49,12 +69,26 @@ namespace melatonin
             addAndMakeVisible (boxModelPanel);
             addAndMakeVisible (colorPickerPanel);
             addAndMakeVisible (previewPanel);
+            addAndMakeVisible (graphicsCallsPanel);
+            addAndMakeVisible (flameChartPanel);
+            addAndMakeVisible (frameTimesPanel);
+            addAndMakeVisible (messageThreadPanel);
+#if JUCE_MODULE_AVAILABLE_juce_audio_processors
+            addChildComponent (processorLoadPanel);
+            addChildComponent (parameterChangesPanel);
+#endif
             addAndMakeVisible (propertiesPanel);
             addAndMakeVisible (accessibilityPanel);
 
             addAndMakeVisible (searchBox);
             addAndMakeVisible (searchIcon);
             addChildComponent (clearButton);
+            addChildComponent (sortByRepaintsToggle);
+
+            flameChart.selectComponentCallback = [this] (Component* c) {
+                if (selectComponentCallback)
+                    selectComponentCallback (c);
+            };
 
             colorPicker.togglePickerCallback = [this] (bool value) {
                 if (toggleOverlayCallback)
@@ -154,6 +188,10 @@ namespace melatonin
                 searchBox.giveAwayKeyboardFocus();
             };
 
+            sortByRepaintsToggle.onClick = [this] {
+                repaintRatesUpdated();
+            };
+
             // TODO: sorta sketchy to "know" the enum default...
             tabToggle.on = settings->props->getIntValue ("selectionMode", 0);
             tabToggle.onClick = [this] {
@@ -182,6 +220,13 @@ namespace melatonin
             root = &r;
             colorPicker.setRootComponent (root);
 
+#if JUCE_MODULE_AVAILABLE_juce_audio_processors
+            auto editor = dynamic_cast<juce::AudioProcessorEditor*> (root);
+            processorLoad.setProcessor (editor != nullptr ? editor->getAudioProcessor() : nullptr);
+            parameterChanges.setProcessor (editor != nullptr ? editor->getAudioProcessor() : nullptr);
+#endif
+            updatePluginPanelsVisibility();
+
             tree.setRootItem (nullptr);
             rootItem = nullptr;
 
@@ -193,6 +238,47 @@ namespace melatonin
         {
             root = nullptr;
             colorPicker.setRootComponent (nullptr);
+#if JUCE_MODULE_AVAILABLE_juce_audio_processors
+            processorLoad.setProcessor (nullptr);
+            parameterChanges.setProcessor (nullptr);
+#endif
+            updatePluginPanelsVisibility();
+        }
+
+        // the frame times panel shows the detailed stats of the on-screen meter
+        void setFPSMeter (FPSMeter& meter)
+        {
+            frameTimes.setFPSMeter (&meter);
+#if JUCE_MODULE_AVAILABLE_juce_audio_processors
+            parameterChanges.setFPSMeter (&meter);
+#endif
+        }
+
+        // automatic timings count repaints, which show up in the tree and properties
+        void setRepaintRatesVisible (bool visible)
+        {
+            sortByRepaintsToggle.setVisible (visible);
+            resized();
+        }
+
+        // shows how many times each pixel of the selected component and its children is painted
+        void setOverdrawVisible (bool visible)
+        {
+            model.showOverdraw = visible;
+            model.refresh();
+        }
+
+        void repaintRatesUpdated()
+        {
+            TRACE_COMPONENT();
+
+            model.updateTimings();
+
+            if (auto item = getRoot())
+            {
+                item->updateRepaintRates (sortByRepaintsToggle.isVisible() && sortByRepaintsToggle.on);
+                tree.repaint();
+            }
         }
 
         void paint (juce::Graphics& g) override
@@ -266,11 +352,31 @@ namespace melatonin
             boxModelPanel.setBounds (mainCol.removeFromTop (32));
             boxModel.setBounds (mainCol.removeFromTop (boxModel.isVisible() ? 280 : 0));
 
-            auto previewHeight = (preview.showsPerformanceTimings()) ? 182 : 132;
+            auto previewHeight = (preview.showsPerformanceTimings()) ? 198 : 132;
             auto previewBounds = mainCol.removeFromTop (preview.isVisible() ? previewHeight : 32);
             preview.setBounds (previewBounds);
             previewPanel.setBounds (previewBounds.removeFromTop (32).removeFromLeft (200));
 
+            graphicsCallsPanel.setBounds (mainCol.removeFromTop (32));
+            graphicsCalls.setBounds (mainCol.removeFromTop (graphicsCalls.isVisible() ? GraphicsCalls::getHeightNeeded() : 0).withTrimmedLeft (32));
+
+            flameChartPanel.setBounds (mainCol.removeFromTop (32));
+            flameChart.setBounds (mainCol.removeFromTop (flameChart.isVisible() ? 220 : 0).withTrimmedLeft (32).withTrimmedRight (12));
+
+            frameTimesPanel.setBounds (mainCol.removeFromTop (32));
+            frameTimes.setBounds (mainCol.removeFromTop (frameTimes.isVisible() ? FrameTimes::getHeightNeeded() : 0).withTrimmedLeft (32).withTrimmedRight (12));
+
+            messageThreadPanel.setBounds (mainCol.removeFromTop (32));
+            messageThread.setBounds (mainCol.removeFromTop (messageThread.isVisible() ? MessageThread::getHeightNeeded() : 0).withTrimmedLeft (32).withTrimmedRight (12));
+
+#if JUCE_MODULE_AVAILABLE_juce_audio_processors
+            processorLoadPanel.setBounds (mainCol.removeFromTop (processorLoadPanel.isVisible() ? 32 : 0));
+            processorLoad.setBounds (mainCol.removeFromTop (processorLoad.isVisible() ? ProcessorLoad::getHeightNeeded() : 0).withTrimmedLeft (32).withTrimmedRight (12));
+
+            parameterChangesPanel.setBounds (mainCol.removeFromTop (parameterChangesPanel.isVisible() ? 32 : 0));
+            parameterChanges.setBounds (mainCol.removeFromTop (parameterChanges.isVisible() ? ParameterChanges::getHeightNeeded() : 0).withTrimmedLeft (32).withTrimmedRight (12));
+#endif
+
             // the picker icon + rgba toggle overlays the panel header, so we overlap it
             auto colorPickerHeight = 72;
             int numColorsToDisplay = juce::jlimit (0, properties.isVisible() ? 12 : 3, (int) model.colors.size());
@@ -289,6 +395,8 @@ namespace melatonin
             searchBoxBounds = area.removeFromTop (headerHeight);
             auto b = searchBoxBounds;
             clearButton.setBounds (b.removeFromRight (48));
+            if (sortByRepaintsToggle.isVisible())
+                sortByRepaintsToggle.setBounds (b.removeFromRight (64));
             searchIcon.setBounds (b.removeFromLeft (48));
             searchBox.setBounds (b.reduced (0, 2));
 
@@ -375,6 +483,11 @@ namespace melatonin
 
             // content visibility is handled by the panel
             previewPanel.setVisible (nowEnabled);
+            graphicsCallsPanel.setVisible (nowEnabled);
+            flameChartPanel.setVisible (nowEnabled);
+            frameTimesPanel.setVisible (nowEnabled);
+            messageThreadPanel.setVisible (nowEnabled);
+            updatePluginPanelsVisibility();
             colorPickerPanel.setVisible (nowEnabled);
             propertiesPanel.setVisible (nowEnabled);
             tree.setVisible (nowEnabled);
@@ -421,6 +534,31 @@ namespace melatonin
         Preview preview { model };
         CollapsablePanel previewPanel { "PREVIEW", &preview };
 
+        // renders the selection offscreen while open, so it starts closed
+        GraphicsCalls graphicsCalls { model };
+        CollapsablePanel graphicsCallsPanel { "GRAPHICS CALLS", &graphicsCalls, false, false };
+
+        // records while open, so it starts closed
+        FlameChart flameChart;
+        CollapsablePanel flameChartPanel { "FLAME CHART", &flameChart, false, false };
+
+        FrameTimes frameTimes;
+        CollapsablePanel frameTimesPanel { "FRAME TIMES", &frameTimes, false, false };
+
+        // runs a watchdog thread while open, so it starts closed
+        MessageThread messageThread;
+        CollapsablePanel messageThreadPanel { "MESSAGE THREAD", &messageThread, false, false };
+
+#if JUCE_MODULE_AVAILABLE_juce_audio_processors
+        // only for plugin editors
+        ProcessorLoad processorLoad;
+        CollapsablePanel processorLoadPanel { "PROCESSOR LOAD", &processorLoad, false, false };
+
+        // listens to every parameter while open, so it starts closed
+        ParameterChanges parameterChanges;
+        CollapsablePanel parameterChangesPanel { "PARAMETER CHANGES", &parameterChanges, false, false };
+#endif
+
         ColorPicker colorPicker { model, preview };
         CollapsablePanel colorPickerPanel { "COLORS", &colorPicker };
 
@@ -436,6 +574,7 @@ namespace melatonin
         juce::Label emptySearchLabel { "EmptySearchResultsPrompt", "No component found" };
         juce::TextEditor searchBox { "Search box" };
         InspectorImageButton clearButton { "clear", { 0, 6 } };
+        PillToggle sortByRepaintsToggle { "REPAINTS" };
         InspectorImageButton searchIcon { "search", { 8, 8 } };
         InspectorImageButton enabledButton { "enabled", { 8, 6 }, true };
         InspectorImageButton lockedButton { "lock", { 0, 6 }, true };
@@ -448,6 +587,21 @@ namespace melatonin
 
         std::unique_ptr<ComponentTreeViewItem> rootItem;
 
+        // panels recall their content's visibility when shown, but don't hide it
+        void updatePluginPanelsVisibility()
+        {
+#if JUCE_MODULE_AVAILABLE_juce_audio_processors
+            auto visible = inspectorEnabled && processorLoad.hasProcessor();
+            processorLoadPanel.setVisible (visible);
+            parameterChangesPanel.setVisible (visible);
+            if (!visible)
+            {
+                processorLoad.setVisible (false);
+                parameterChanges.setVisible (false);
+            }
+#endif
+        }
+
         ComponentTreeViewItem* getRoot() const
         {
             return dynamic_cast<ComponentTreeViewItem*> (tree.getRootItem());
@@ -259,5 +259,16 @@ namespace melatonin
             return font.getStringWidthFloat (text);
 #endif
         }
+
+        // label on the left, value on the right, for the stats panels
+        static constexpr int statLabelWidth = 120;
+
+        static void drawStatRow (juce::Graphics& g, juce::Rectangle<int> bounds, const juce::String& label, const juce::String& value, bool isWarning)
+        {
+            g.setColour (colors::propertyName);
+            g.drawText (label, bounds.removeFromLeft (statLabelWidth), juce::Justification::centredLeft);
+            g.setColour (isWarning ? colors::propertyValueWarn : colors::propertyValue);
+            g.drawText (value, bounds, juce::Justification::centredLeft, true);
+        }
     };
 }
@@ -14,11 +14,20 @@ END_JUCE_MODULE_DECLARATION
 */
 #pragma once
 
+#include "melatonin_inspector/melatonin/helpers/trace.h"
+
 #ifndef PERFETTO
-    #define TRACE_COMPONENT(...)
-    #define TRACE_EVENT(category, ...)
-    #define TRACE_EVENT_BEGIN(category, ...)
-    #define TRACE_EVENT_END(category)
+    #if MELATONIN_TRACE
+        #define TRACE_COMPONENT(...) MELATONIN_TRACE_SCOPE ("component", MELATONIN_TRACE_FUNCTION)
+        #define TRACE_EVENT(...) MELATONIN_TRACE_SCOPE (__VA_ARGS__)
+        #define TRACE_EVENT_BEGIN(...) melatonin::Trace::begin (__VA_ARGS__)
+        #define TRACE_EVENT_END(category) melatonin::Trace::end (category)
+    #else
+        #define TRACE_COMPONENT(...)
+        #define TRACE_EVENT(category, ...)
+        #define TRACE_EVENT_BEGIN(category, ...)
+        #define TRACE_EVENT_END(category)
+    #endif
 #endif
 
 #include "melatonin/lookandfeel.h"
@@ -73,6 +82,12 @@ namespace melatonin
             TRACE_COMPONENT();
             this->addKeyListener (&keyListener);
 
+            // the inspector's own ui shouldn't show up in timings
+            automaticTimings.ignore (overlay);
+            automaticTimings.ignore (fpsMeter);
+            automaticTimings.ignore (fpsMeter.getPaintProbe());
+            inspectorComponent.setFPSMeter (fpsMeter);
+
             setRoot (rootComponent);
 
             // needs to come before the LNF
@@ -132,6 +147,7 @@ namespace melatonin
             fpsMeter.setRoot (*root);
             overlayMouseListener.setRoot (*root);
             inspectorComponent.setRoot (*root);
+            automaticTimings.setRoot (*root);
         }
 
         void clearRoot()
@@ -145,6 +161,7 @@ namespace melatonin
             fpsMeter.clearRoot();
             overlayMouseListener.clearRoot();
             inspectorComponent.clearRoot();
+            automaticTimings.clearRoot();
         }
 
         void moved() override
@@ -346,6 +363,50 @@ namespace melatonin
                 stopTimer();
         }
 
+        // times the paint and counts the repaints of every component under the root, no ComponentTimer needed
+        // handy for stock JUCE widgets, but leaves components with their own CachedComponentImage alone
+        void setAutomaticTimings (bool enable)
+        {
+            automaticTimingsRequested = enable;
+            updateAutomaticTimings();
+        }
+
+        // briefly highlights every area that repaints, going from green to red the more it repaints
+        // this keeps automatic timings on while flashing, as that's where repaints are picked up
+        void setPaintFlashing (bool enable)
+        {
+            paintFlashing = enable;
+            updateAutomaticTimings();
+            overlay.setPaintFlashing (enable);
+        }
+
+        // covers the root with a heatmap of how many times each pixel is painted per frame
+        // the selected component's overdraw ratio shows up in Properties
+        void setOverdrawHeatmap (bool enable)
+        {
+            overlay.setOverdrawHeatmap (enable);
+            inspectorComponent.setOverdrawVisible (enable);
+        }
+
+        // grows the FPS meter into a HUD docked in a corner of the root
+        // it shows a frame time sparkline and the 3 components that spent the most time painting in the last second
+        // the inspector window doesn't need to be open, but the components need timings (automatic or ComponentTimer)
+        // turning it off goes back to the compact meter, the FPS toggle and its saved state are left alone
+        void setPerformanceHUD (bool enable, FPSMeter::Corner corner = FPSMeter::Corner::topRight)
+        {
+            fpsMeter.setHUD (enable, corner);
+
+            if (enable)
+                fpsMeter.setVisible (true);
+        }
+
+        // the FPS meter normally repaints itself every vblank, which can cause full repaints of the root (see the FAQ)
+        // passive, it timestamps the root's real paint passes instead and only redraws itself a few times a second
+        void setPassiveFPSMeter (bool enable)
+        {
+            fpsMeter.setPassive (enable);
+        }
+
         std::function<void()> onClose;
 
     private:
@@ -360,15 +421,28 @@ namespace melatonin
         Overlay overlay;
         FPSMeter fpsMeter;
         OverlayMouseListener overlayMouseListener;
+        AutomaticTimings automaticTimings;
         InspectorKeyCommands keyListener { *this };
         bool rootFollowsComponentUnderMouse = false;
 
+        // paint flashing needs automatic timings, but shouldn't leave them on once it's done
+        bool automaticTimingsRequested = false;
+        bool paintFlashing = false;
+
+        void updateAutomaticTimings()
+        {
+            auto enable = automaticTimingsRequested || paintFlashing;
+            automaticTimings.setEnabled (enable);
+            inspectorComponent.setRepaintRatesVisible (enable);
+        }
+
         // Resize our overlay when the root component changes
         void componentMovedOrResized (Component& rootComponent, bool wasMoved, bool wasResized) override
         {
             if (wasResized || wasMoved)
             {
                 overlay.setBounds (rootComponent.getLocalBounds());
+                fpsMeter.updateBounds();
             }
         }
 
@@ -433,7 +507,7 @@ namespace melatonin
             };
             inspectorComponent.toggleFPSCallback = [this] (const bool enable) {
                 if (enable)
-                    this->fpsMeter.setBounds (root->getLocalBounds().removeFromRight (60).removeFromTop (40));
+                    this->fpsMeter.updateBounds();
                 this->fpsMeter.setVisible (enable);
                 settings->props->setValue ("fpsEnabled", enable);
             };
@@ -442,6 +516,8 @@ namespace melatonin
             inspectorComponent.toggleSelectionMode = [this] (const bool enable) { this->setSelectionMode (enable ? FOLLOWS_FOCUS : FOLLOWS_MOUSE); };
             inspectorComponent.toggleLockCallback = [this] (const bool enable) { this->setSelectionLock (enable); };
             inspectorComponent.toggleUndoManagerCallback = [this] (const bool enable) { this->toggleUndoManager (enable); };
+
+            automaticTimings.onRepaintRatesUpdated = [this] { inspectorComponent.repaintRatesUpdated(); };
         }
 
         enum SelectionMode {
@@ -0,0 +1,222 @@
+#include <melatonin_inspector/melatonin_inspector.h>
+
+// Built with MELATONIN_TIMING_TABLE_SIZE=8, so a handful of components fill the table
+
+class TimingHistogramTests : public juce::UnitTest
+{
+public:
+    TimingHistogramTests() : juce::UnitTest ("TimingHistogram", "melatonin") {}
+
+    void runTest() override
+    {
+        constexpr double us = 1.0 / (1000.0 * 1000.0);
+        constexpr double tolerance = 1.0e-12;
+
+        beginTest ("empty histogram reports zero");
+        {
+            melatonin::TimingHistogram h;
+            expectWithinAbsoluteError (h.getPercentile (50), 0.0, tolerance);
+            expectEquals (h.summarize().count, (juce::uint64) 0);
+        }
+
+        beginTest ("sub-microsecond samples share the first bucket");
+        {
+            melatonin::TimingHistogram h;
+            h.record (0.1 * us);
+            h.record (0.9 * us);
+            expectWithinAbsoluteError (h.getPercentile (50), 0.5 * us, tolerance);
+        }
+
+        beginTest ("percentiles at a bucket edge");
+        {
+            // 1.999µs is the top sub-bucket of the first octave, 2µs starts the next octave
+            melatonin::TimingHistogram h;
+            for (int i = 0; i < 50; ++i)
+                h.record (1.999 * us);
+            for (int i = 0; i < 49; ++i)
+                h.record (2.0 * us);
+            h.record (1000.0 * us);
+
+            expectEquals (h.getCount(), (juce::uint64) 100);
+
+            // the 50th sample is the last 1.999µs one, the 51st is the first at 2µs
+            expectWithinAbsoluteError (h.getPercentile (50), 1.875 * us, tolerance);
+            expectWithinAbsoluteError (h.getPercentile (51), 2.25 * us, tolerance);
+            expectWithinAbsoluteError (h.getPercentile (99), 2.25 * us, tolerance);
+
+            // the midpoint of [896µs, 1024µs) is 960µs
+            expectWithinAbsoluteError (h.getPercentile (100), 960.0 * us, tolerance);
+            expectWithinAbsoluteError (h.getMax(), 1000.0 * us, tolerance);
+        }
+
+        beginTest ("a midpoint above the max reports the max");
+        {
+            melatonin::TimingHistogram h;
+            h.record (1.0 * us);
+            expectWithinAbsoluteError (h.getPercentile (50), 1.0 * us, tolerance);
+        }
+
+        beginTest ("the top sub-bucket merges with overflow");
+        {
+            // [917504µs, 1048576µs) is the top sub-bucket of the last octave
+            // it's also where everything past ~1s lands, so it reports the max
+            melatonin::TimingHistogram h;
+            h.record (0.95);
+            expectWithinAbsoluteError (h.getPercentile (50), 0.95, tolerance);
+
+            h.record (5.0);
+            expectWithinAbsoluteError (h.getPercentile (50), 5.0, tolerance);
+            expectWithinAbsoluteError (h.getPercentile (100), 5.0, tolerance);
+        }
+
+        beginTest ("the sub-bucket below the top still reports its midpoint");
+        {
+            melatonin::TimingHistogram h;
+            h.record (0.8);
+            h.record (5.0);
+            expectWithinAbsoluteError (h.getPercentile (50), 851968.0 * us, tolerance);
+            expectWithinAbsoluteError (h.getPercentile (100), 5.0, tolerance);
+        }
+
+        beginTest ("reset clears everything");
+        {
+            melatonin::TimingHistogram h;
+            h.record (0.01);
+            h.reset();
+            expectEquals (h.getCount(), (juce::uint64) 0);
+            expectWithinAbsoluteError (h.getMax(), 0.0, tolerance);
+            expectWithinAbsoluteError (h.getPercentile (99), 0.0, tolerance);
+        }
+    }
+};
+
+class TimingTableTests : public juce::UnitTest
+{
+public:
+    TimingTableTests() : juce::UnitTest ("TimingTable", "melatonin") {}
+
+    void runTest() override
+    {
+        auto& table = melatonin::TimingTable::getInstance();
+        static_assert (melatonin::TimingTable::capacity == 8, "these tests fill the table");
+
+        beginTest ("a reused address gets a fresh entry");
+        {
+            // constructing in the same storage guarantees the address is reused
+            alignas (juce::Component) std::byte storage[sizeof (juce::Component)];
+
+            auto* first = new (storage) juce::Component();
+            auto* entry = table.getOrCreate (first);
+            expect (entry != nullptr);
+            entry->invalidations = 42;
+            entry->exclusive.record (0.001);
+            first->~Component();
+
+            expect (table.find (first) == nullptr);
+
+            auto* second = new (storage) juce::Component();
+            expect (table.find (second) == nullptr);
+
+            auto* recycled = table.getOrCreate (second);
+            expect (recycled == entry);
+            expectEquals (recycled->invalidations, (juce::uint64) 0);
+            expectEquals (recycled->exclusive.getCount(), (juce::uint64) 0);
+            second->~Component();
+        }
+
+        beginTest ("probe chains continue across dead slots");
+        {
+            // a full table means most components sit past their home slot
+            std::array<std::unique_ptr<juce::Component>, melatonin::TimingTable::capacity> components;
+            std::array<melatonin::TimingTable::Entry*, melatonin::TimingTable::capacity> entries {};
+            for (size_t i = 0; i < components.size(); ++i)
+            {
+                components[i] = std::make_unique<juce::Component>();
+                entries[i] = table.getOrCreate (components[i].get());
+                expect (entries[i] != nullptr);
+            }
+
+            // the dead slots stay in the chains, so the survivors are still found
+            for (size_t i = 0; i < components.size(); i += 2)
+                components[i].reset();
+
+            for (size_t i = 1; i < components.size(); i += 2)
+                expect (table.find (components[i].get()) == entries[i]);
+
+            // and the dead slots are reused for new components
+            for (size_t i = 0; i < components.size(); i += 2)
+            {
+                components[i] = std::make_unique<juce::Component>();
+                entries[i] = table.getOrCreate (components[i].get());
+                expect (entries[i] != nullptr);
+            }
+
+            for (size_t i = 0; i < components.size(); ++i)
+            {
+                expect (table.find (components[i].get()) == entries[i]);
+                for (size_t j = i + 1; j < components.size(); ++j)
+                    expect (entries[i] != entries[j]);
+            }
+        }
+
+        beginTest ("findMostExpensive orders by paint time");
+        {
+            std::array<juce::Component, 5> components;
+            const std::array<float, 5> paintMs { 1.0f, 5.0f, 0.0f, 3.0f, 9.0f };
+
+            std::array<melatonin::TimingTable::Entry*, 5> entries {};
+            for (size_t i = 0; i < components.size(); ++i)
+            {
+                entries[i] = table.getOrCreate (&components[i]);
+                expect (entries[i] != nullptr);
+                entries[i]->paintMsPerSecond = paintMs[i];
+            }
+
+            std::array<const melatonin::TimingTable::Entry*, 3> top {};
+            table.findMostExpensive (top);
+            expect (top[0] == entries[4]);
+            expect (top[1] == entries[1]);
+            expect (top[2] == entries[3]);
+
+            // components that didn't paint are left out
+            std::array<const melatonin::TimingTable::Entry*, 5> all {};
+            table.findMostExpensive (all);
+            expect (all[3] == entries[0]);
+            expect (all[4] == nullptr);
+        }
+
+        beginTest ("findMostExpensive skips deleted components");
+        {
+            auto expensive = std::make_unique<juce::Component>();
+            juce::Component cheap;
+
+            table.getOrCreate (expensive.get())->paintMsPerSecond = 10.0f;
+            table.getOrCreate (&cheap)->paintMsPerSecond = 1.0f;
+            expensive.reset();
+
+            std::array<const melatonin::TimingTable::Entry*, 2> top {};
+            table.findMostExpensive (top);
+            expect (top[0] == table.find (&cheap));
+            expect (top[1] == nullptr);
+        }
+    }
+};
+
+static TimingHistogramTests timingHistogramTests;
+static TimingTableTests timingTableTests;
+
+int main()
+{
+    // components need a message manager
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::UnitTestRunner runner;
+    runner.setAssertOnFailure (false);
+    runner.runTestsInCategory ("melatonin");
+
+    for (int i = 0; i < runner.getNumResults(); ++i)
+        if (runner.getResult (i)->failures > 0)
+            return 1;
+
+    return 0;
+}